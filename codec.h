@@ -0,0 +1,557 @@
+/**
+ * \file
+ * Part of the text handling classes, binary to text codecs for carrying binary data and diagnostics over text lines
+ * PROJECT          : FRTOS GCPP
+ * TARGET SYSTEM    : Arduino, Maple Mini
+ */
+
+#ifndef codec_h
+#define codec_h
+
+#include "string_helper.h"
+#include "text.h"
+
+/**
+ * Hex dump line length for w bytes per line, \ref nText::cHex::dumpLine.  Offset, hex column, ASCII column and "\r\n"
+ */
+#define CHEX_DUMP_LENGTH(w)         (4*(w)+15)
+
+
+/**
+ * Base64 output size for n input bytes, \ref nText::cBase64Encoder.  Not including NULL
+ */
+#define CBASE64_ENCODE_MAX(n)       ((((n)+2)/3)*4)
+
+
+/**
+ * Base64 decode output size for n input characters, \ref nText::cBase64Decoder.  Includes a group held from earlier calls
+ */
+#define CBASE64_DECODE_MAX(n)       (((n)/4)*3+3)
+
+
+namespace nText {
+    /**
+     * A class of hex helpers for buffers.  Digits come from a nibble table, \ref cStringHelper::hexDigits, so every byte is two
+     * characters with leading zeros kept
+     */
+    class cHex {
+        public:
+            /**
+             * Encode bytes as hex pairs, output is NULL terminated
+             *
+             * \param[out] pscOut Pointer to output
+             * \param[in] usOutSize Output size (characters, including NULL)
+             * \param[in] pucIn Pointer to bytes
+             * \param[in] usLength Byte count
+             * \param[in] scSeparator Character between pairs, 0 for none
+             * \return Output length (characters, not including NULL).  Only whole pairs are output, bytes encoded is
+             * (length+1)/3 with a separator, length/2 without
+             */
+            static uint16_t encode(char *pscOut, const uint16_t usOutSize, const uint8_t *pucIn, const uint16_t usLength,
+                                                                                                        const char scSeparator = 0) {
+                const char *pscDigits=cStringHelper::hexDigits();
+                uint16_t usO=0, usI;
+
+                for(usI=0;usI<usLength;usI++) {
+                    if (usO+(usI && scSeparator ? 3 : 2)>=usOutSize) {
+                        break;
+                    }
+                    if (usI && scSeparator) {
+                        pscOut[usO++]=scSeparator;
+                    }
+                    pscOut[usO++]=pgm_read_byte(&pscDigits[pucIn[usI]>>4]);
+                    pscOut[usO++]=pgm_read_byte(&pscDigits[pucIn[usI]&15]);
+                }
+                if (usO<usOutSize) {
+                    pscOut[usO]=0x00;
+                }
+
+                return usO;
+            }
+
+
+            /**
+             * Decode hex pairs to bytes, either case.  A single space, tab, ':', '-' or ',' may separate pairs.  Decoding stops at
+             * any other character, an unpaired digit or when output is full
+             *
+             * \param[out] pucOut Pointer to output
+             * \param[in] usOutSize Output size (bytes)
+             * \param[in] pscIn Pointer to characters, need not be NULL terminated
+             * \param[in] usLength Characters available
+             * \param[out] usUsed Characters consumed
+             * \return Output length (bytes)
+             */
+            static uint16_t decode(uint8_t *pucOut, const uint16_t usOutSize, const char *pscIn, const uint16_t usLength,
+                                                                                                                uint16_t &usUsed) {
+                uint16_t usO=0, usI=0;
+                int8_t scHigh, scLow;
+
+                usUsed=0;
+                while(usO<usOutSize) {
+                    if (usO && usI<usLength && isSeparator(pscIn[usI])) {
+                        usI++;
+                    }
+                    if (usI+1>=usLength || (scHigh=cStringHelper::hexValue(pscIn[usI]))<0 ||
+                                                                        (scLow=cStringHelper::hexValue(pscIn[usI+1]))<0) {
+                        break;
+                    }
+                    pucOut[usO++]=static_cast<uint8_t>((scHigh<<4) | scLow);
+                    usI+=2;
+                    usUsed=usI;
+                }
+
+                return usO;
+            }
+
+
+            /**
+             * Hex dump bytes per line that fit a text line
+             *
+             * \tparam N Text line length (characters), at least CHEX_DUMP_LENGTH(1)
+             * \return Bytes per line, 1 to 16
+             */
+            template <uint16_t N>
+            static uint8_t dumpWidth() {
+                return ((N-15)/4>16) ? 16 : static_cast<uint8_t>((N-15)/4);
+            }
+
+
+            /**
+             * Format one hex dump line in place, e.g. for 4 bytes per line
+             *
+             * 00000010  48 65 6c 00  |Hel.|\r\n
+             *
+             * Short last lines are padded so columns align
+             *
+             * \param[out] xLine Reference to text line, N at least CHEX_DUMP_LENGTH(ucWidth)
+             * \param[in] ulOffset Offset shown for first byte
+             * \param[in] pucData Pointer to bytes
+             * \param[in] ucCount Byte count, at most ucWidth
+             * \param[in] ucWidth Bytes per line, limited to \ref dumpWidth
+             * \return Bytes formatted
+             */
+            template <uint16_t N>
+            static uint8_t dumpLine(cTextLine<N> &xLine, const uint32_t ulOffset, const uint8_t *pucData, uint8_t ucCount,
+                                                                                                            uint8_t ucWidth = 16) {
+                const char *pscDigits=cStringHelper::hexDigits();
+                char *psc=xLine.getBuffer();
+                uint8_t ucI, ucO=0;
+
+                static_assert(N>=CHEX_DUMP_LENGTH(1), "cHex dump line N too short");
+                if (ucWidth>dumpWidth<N>()) {
+                    ucWidth=dumpWidth<N>();
+                }
+                if (ucCount>ucWidth) {
+                    ucCount=ucWidth;
+                }
+
+                for(ucI=0;ucI<8;ucI++) {
+                    psc[ucO++]=pgm_read_byte(&pscDigits[(ulOffset>>(28-4*ucI))&15]);
+                }
+                psc[ucO++]=' ';
+                for(ucI=0;ucI<ucWidth;ucI++) {
+                    psc[ucO++]=' ';
+                    if (ucI<ucCount) {
+                        psc[ucO++]=pgm_read_byte(&pscDigits[pucData[ucI]>>4]);
+                        psc[ucO++]=pgm_read_byte(&pscDigits[pucData[ucI]&15]);
+                    }else {
+                        psc[ucO++]=' ';
+                        psc[ucO++]=' ';
+                    }
+                }
+                psc[ucO++]=' ';
+                psc[ucO++]=' ';
+                psc[ucO++]='|';
+                for(ucI=0;ucI<ucCount;ucI++) {
+                    psc[ucO++]=(pucData[ucI]>=0x20 && pucData[ucI]<0x7f) ? static_cast<char>(pucData[ucI]) : '.';
+                }
+                psc[ucO++]='|';
+                psc[ucO++]='\r';
+                psc[ucO++]='\n';
+                xLine.setLineLength(ucO);
+
+                return ucCount;
+            }
+
+
+            /**
+             * Hex dump buffer through a TX engine like \ref nFRTOSPeripheral::cUARTTX, one line per \ref dumpWidth bytes
+             *
+             * \param[in] xTX Reference to TX engine
+             * \param[in] xLine Reference to text line used for formatting, type matches TX engine
+             * \param[in] pucData Pointer to bytes
+             * \param[in] usLength Byte count
+             * \param[in] ulOffset Offset shown for first byte.  Default 0
+             * \return Bytes dumped, short when transmit fails
+             */
+            template <class T, uint16_t N>
+            static uint16_t dump(T &xTX, cTextLine<N> &xLine, const uint8_t *pucData, const uint16_t usLength,
+                                                                                                    const uint32_t ulOffset = 0) {
+                uint16_t usI=0;
+                uint8_t ucCount;
+
+                while(usI<usLength) {
+                    ucCount=dumpLine(xLine, ulOffset+usI, &pucData[usI],
+                                            (usLength-usI>dumpWidth<N>()) ? dumpWidth<N>() : static_cast<uint8_t>(usLength-usI));
+                    if (!xTX.transmit(xLine)) {
+                        break;
+                    }
+                    usI+=ucCount;
+                }
+
+                return usI;
+            }
+
+        protected:
+            /**
+             * Separator test, \ref decode
+             *
+             * \param[in] sc Character
+             * \return Separator state
+             */
+            static bool isSeparator(const char sc) {
+                return ' '==sc || '\t'==sc || ':'==sc || '-'==sc || ','==sc;
+            }
+    }; // class cHex
+
+
+    /**
+     * Base64 alphabets, \ref cBase64Encoder
+     */
+    typedef enum {
+        eBASE64_STD=0,          ///< RFC 4648 "+/" with '=' padding
+        eBASE64_URL             ///< RFC 4648 URL and file safe "-_", padding optional
+    }eBASE64;
+
+
+    /**
+     * A class implementing an incremental Base64 encoder.  Input may arrive in any size pieces, up to 2 bytes are held between
+     * calls so output is always whole 4 character groups until \ref end.  Output has no line endings so fits line based links
+     */
+    class cBase64Encoder {
+        public:
+            /**
+             * Constructor.  Make stable instance
+             *
+             * \param[in] eAlphabet Alphabet.  Default eBASE64_STD
+             * \param[in] bPad Pad last group with '='.  Default true
+             */
+            cBase64Encoder(const eBASE64 eAlphabet = eBASE64_STD, const bool bPad = true) : _eAlphabet(eAlphabet), _bPad(bPad) {
+                reset();
+            }
+
+
+            /**
+             * Drop held bytes, start new stream
+             */
+            void reset() {
+                _ucHeldCount=0;
+            }
+
+
+            /**
+             * Get held bytes state, \ref end outputs them
+             *
+             * \return Held state
+             */
+            bool isPending() const {
+                return _ucHeldCount>0;
+            }
+
+
+            /**
+             * Encode bytes, output is NULL terminated when there is room.  Bytes are consumed only while output has room for their group
+             *
+             * \param[out] pscOut Pointer to output, CBASE64_ENCODE_MAX(usLength) characters for all input
+             * \param[in] usOutSize Output size (characters)
+             * \param[in] pucIn Pointer to bytes
+             * \param[in] usLength Byte count
+             * \param[out] usUsed Bytes consumed, including those held
+             * \return Output length (characters, not including NULL), multiple of 4
+             */
+            uint16_t encode(char *pscOut, const uint16_t usOutSize, const uint8_t *pucIn, const uint16_t usLength, uint16_t &usUsed) {
+                uint16_t usO=0, usI=0;
+
+                // complete held group
+                while(_ucHeldCount && usI<usLength) {
+                    if (2==_ucHeldCount) {
+                        if (usO+4>usOutSize) {
+                            break;
+                        }
+                        group(&pscOut[usO], _ucHeld[0], _ucHeld[1], pucIn[usI++]);
+                        usO+=4;
+                        _ucHeldCount=0;
+                    }else {
+                        _ucHeld[_ucHeldCount++]=pucIn[usI++];
+                    }
+                }
+
+                // whole groups
+                if (!_ucHeldCount) {
+                    for(;usI+3<=usLength && usO+4<=usOutSize;usI+=3,usO+=4) {
+                        group(&pscOut[usO], pucIn[usI], pucIn[usI+1], pucIn[usI+2]);
+                    }
+                    // hold tail for next group
+                    if (usLength-usI<3) {
+                        while(usI<usLength) {
+                            _ucHeld[_ucHeldCount++]=pucIn[usI++];
+                        }
+                    }
+                }
+                if (usO<usOutSize) {
+                    pscOut[usO]=0x00;
+                }
+                usUsed=usI;
+
+                return usO;
+            }
+
+
+            /**
+             * End stream, output held bytes as a short group
+             *
+             * \param[out] pscOut Pointer to output, at least 5 characters
+             * \return Output length (characters, not including NULL).  0 to 4
+             */
+            uint8_t end(char *pscOut) {
+                const char *pscTable=table();
+                uint8_t ucO=0;
+
+                if (_ucHeldCount) {
+                    uint8_t ucB=(2==_ucHeldCount) ? _ucHeld[1] : 0;
+
+                    pscOut[ucO++]=pgm_read_byte(&pscTable[_ucHeld[0]>>2]);
+                    pscOut[ucO++]=pgm_read_byte(&pscTable[((_ucHeld[0]&0x03)<<4) | (ucB>>4)]);
+                    if (2==_ucHeldCount) {
+                        pscOut[ucO++]=pgm_read_byte(&pscTable[(ucB&0x0f)<<2]);
+                    }
+                    while(_bPad && ucO<4) {
+                        pscOut[ucO++]='=';
+                    }
+                    _ucHeldCount=0;
+                }
+                pscOut[ucO]=0x00;
+
+                return ucO;
+            }
+
+
+            /**
+             * Encode bytes into a text line for line based links, e.g. \ref nFRTOSPeripheral::cUARTTX.  The line holds whole groups
+             * followed by "\r\n" so each line decodes on its own.  Call until all input is consumed and \ref isPending is false, e.g.
+             *
+             * do {
+             *     usI+=xEncoder.encodeLine(xLine, &pucBlob[usI], usLength-usI, true);
+             *     xTX.transmit(xLine);
+             * }while(usI<usLength || xEncoder.isPending());
+             *
+             * \param[out] xLine Reference to text line, N at least 6
+             * \param[in] pucIn Pointer to bytes
+             * \param[in] usLength Byte count
+             * \param[in] bEnd Last input of stream, \ref end once all input is consumed
+             * \return Bytes consumed
+             */
+            template <uint16_t N>
+            uint16_t encodeLine(cTextLine<N> &xLine, const uint8_t *pucIn, const uint16_t usLength, const bool bEnd) {
+                char *psc=xLine.getBuffer();
+                uint16_t usUsed, usO;
+
+                static_assert(N>=6, "cBase64Encoder line N too short");
+                usO=encode(psc, ((N-2)/4)*4, pucIn, usLength, usUsed);
+                if (bEnd && usUsed==usLength && usO+4<=N-2) {
+                    usO+=end(&psc[usO]);
+                }
+                psc[usO++]='\r';
+                psc[usO++]='\n';
+                xLine.setLineLength(static_cast<uint8_t>(usO));
+
+                return usUsed;
+            }
+
+        protected:
+            /**
+             * Encode one group of 3 bytes
+             *
+             * \param[out] psc Pointer to output, 4 characters
+             * \param[in] ucA First byte
+             * \param[in] ucB Second byte
+             * \param[in] ucC Third byte
+             */
+            void group(char *psc, const uint8_t ucA, const uint8_t ucB, const uint8_t ucC) const {
+                const char *pscTable=table();
+
+                psc[0]=pgm_read_byte(&pscTable[ucA>>2]);
+                psc[1]=pgm_read_byte(&pscTable[((ucA&0x03)<<4) | (ucB>>4)]);
+                psc[2]=pgm_read_byte(&pscTable[((ucB&0x0f)<<2) | (ucC>>6)]);
+                psc[3]=pgm_read_byte(&pscTable[ucC&0x3f]);
+            }
+
+
+            /**
+             * Alphabet in flash
+             *
+             * \return Pointer to table (PROGMEM)
+             */
+            const char *table() const {
+                static const char _scStd[] PROGMEM = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+                static const char _scURL[] PROGMEM = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+                return (eBASE64_URL==_eAlphabet) ? _scURL : _scStd;
+            }
+
+        protected:
+            eBASE64             _eAlphabet;
+            bool                _bPad;
+            uint8_t             _ucHeld[2];         ///< Bytes held for next group
+            uint8_t             _ucHeldCount;
+    }; // class cBase64Encoder
+
+
+    /**
+     * A class implementing an incremental Base64 decoder accepting both alphabets, \ref eBASE64.  Characters may arrive in any
+     * size pieces, a partial group is held between calls.  Line endings, spaces and tabs are skipped, '=' ends a group
+     */
+    class cBase64Decoder {
+        public:
+            /**
+             * Default constructor.  Make stable instance
+             */
+            cBase64Decoder() {
+                reset();
+            }
+
+
+            /**
+             * Drop partial group and error state, start new stream
+             */
+            void reset() {
+                _ulBits=0;
+                _ucCount=0;
+                _bError=false;
+            }
+
+
+            /**
+             * Get error state, set on a character outside the alphabets or misplaced '='.  Cleared by \ref reset
+             *
+             * \return Error state
+             */
+            bool isError() const {
+                return _bError;
+            }
+
+
+            /**
+             * Decode characters.  Decoding stops on error or when output has no room for the next group
+             *
+             * \param[out] pucOut Pointer to output, CBASE64_DECODE_MAX(usLength) bytes for all input
+             * \param[in] usOutSize Output size (bytes)
+             * \param[in] pscIn Pointer to characters, need not be NULL terminated
+             * \param[in] usLength Characters available
+             * \param[out] usUsed Characters consumed
+             * \return Output length (bytes)
+             */
+            uint16_t decode(uint8_t *pucOut, const uint16_t usOutSize, const char *pscIn, const uint16_t usLength, uint16_t &usUsed) {
+                uint16_t usO=0, usI;
+                uint8_t ucValue;
+
+                for(usI=0;usI<usLength && !_bError;usI++) {
+                    const char sc=pscIn[usI];
+
+                    if ('\r'==sc || '\n'==sc || ' '==sc || '\t'==sc) {
+                        continue;
+                    }
+                    if ('='==sc) {
+                        // short group, second '=' of a pair is ignored
+                        if (_ucCount && usO+_ucCount-1>usOutSize) {
+                            break;
+                        }
+                        usO+=flush(&pucOut[usO]);
+                        continue;
+                    }
+                    ucValue=(sc>='+' && sc<='z') ? pgm_read_byte(&table()[sc-'+']) : 0xff;
+                    if (0xff==ucValue) {
+                        _bError=true;
+                        break;
+                    }
+                    if (3==_ucCount && usO+3>usOutSize) {
+                        break;
+                    }
+                    _ulBits=(_ulBits<<6) | ucValue;
+                    if (4==++_ucCount) {
+                        pucOut[usO++]=static_cast<uint8_t>(_ulBits>>16);
+                        pucOut[usO++]=static_cast<uint8_t>(_ulBits>>8);
+                        pucOut[usO++]=static_cast<uint8_t>(_ulBits);
+                        _ulBits=0;
+                        _ucCount=0;
+                    }
+                }
+                usUsed=usI;
+
+                return usO;
+            }
+
+
+            /**
+             * End stream, output a held short group for unpadded input
+             *
+             * \param[out] pucOut Pointer to output, at least 2 bytes
+             * \return Output length (bytes).  0 to 2
+             */
+            uint8_t end(uint8_t *pucOut) {
+                return flush(pucOut);
+            }
+
+        protected:
+            /**
+             * Output short group of 2 or 3 characters, 1 character is an error
+             *
+             * \param[out] pucOut Pointer to output, at least 2 bytes
+             * \return Output length (bytes)
+             */
+            uint8_t flush(uint8_t *pucOut) {
+                uint8_t ucO=0;
+
+                if (1==_ucCount) {
+                    _bError=true;
+                }else if (_ucCount>1) {
+                    _ulBits<<=6*(4-_ucCount);
+                    pucOut[ucO++]=static_cast<uint8_t>(_ulBits>>16);
+                    if (3==_ucCount) {
+                        pucOut[ucO++]=static_cast<uint8_t>(_ulBits>>8);
+                    }
+                }
+                _ulBits=0;
+                _ucCount=0;
+
+                return ucO;
+            }
+
+
+            /**
+             * Sextet values of '+' to 'z' in flash, 0xff not in either alphabet
+             *
+             * \return Pointer to table (PROGMEM)
+             */
+            static const uint8_t *table() {
+                static const uint8_t _ucValues[] PROGMEM = {
+                    0x3e, 0xff, 0x3e, 0xff, 0x3f, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0xff,
+                    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09,
+                    0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19,
+                    0xff, 0xff, 0xff, 0xff, 0x3f, 0xff, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23,
+                    0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33
+                };
+
+                return _ucValues;
+            }
+
+        protected:
+            uint32_t            _ulBits;            ///< Partial group sextets
+            uint8_t             _ucCount;           ///< Partial group sextet count
+            bool                _bError;
+    }; // class cBase64Decoder
+
+
+} // namespace nText
+
+#endif // codec_h
@@ -0,0 +1,365 @@
+/**
+ * \file
+ * Part of the text handling classes, streaming compression of text for slow links.  Host decoder is tools/lzss_decode.py
+ * PROJECT          : FRTOS GCPP
+ * TARGET SYSTEM    : Arduino, Maple Mini
+ */
+
+#ifndef compress_h
+#define compress_h
+
+#include "framing.h"
+
+/**
+ * Worst case compressed size of n input bytes passed to \ref nText::cCompress::compress, including bits pending from earlier calls
+ */
+#define CCOMPRESS_OUT_MAX(n)        ((n)+(n)/8+2)
+
+
+/**
+ * Worst case size of block end output, \ref nText::cCompress::end
+ */
+#define CCOMPRESS_END_MAX           3
+
+
+/**
+ * Match candidates tried per token by \ref nText::cCompressLZSS, bounds CPU cost per byte.  Define your own should you wish to
+ * change, higher improves ratio
+ */
+#if !defined(CCOMPRESS_LZSS_CHAIN)
+    #define CCOMPRESS_LZSS_CHAIN    8
+#endif
+
+
+namespace nText {
+    /**
+     * An abstract class for streaming compressors.  Output is a byte stream, blocks are ended on demand (idle link) so the decoder
+     * can output all data sent so far
+     */
+    class cCompress {
+        public:
+            /**
+             * Compression statistics, \ref getStats.  Ratio is ulIn/ulOut, CPU cost is ulMicros/ulIn
+             */
+            typedef struct {
+                uint32_t        ulIn;               ///< Bytes in
+                uint32_t        ulOut;              ///< Bytes out
+                uint32_t        ulMicros;           ///< Time spent compressing (microseconds)
+                uint32_t        ulBlocks;           ///< Blocks ended
+            }tCompressStats;
+
+
+            /**
+             * Default constructor.  Make stable instance
+             */
+            cCompress() {
+                memset(&_xStats, 0, sizeof(_xStats));
+            }
+
+
+            /**
+             * Compress bytes, output may be held back until more input or \ref end
+             *
+             * \param[in] pucIn Pointer to input
+             * \param[in] usLength Input length (bytes)
+             * \param[out] pucOut Pointer to output, at least CCOMPRESS_OUT_MAX(usLength) bytes
+             * \return Output length (bytes)
+             */
+            uint16_t compress(const uint8_t *pucIn, const uint16_t usLength, uint8_t *pucOut) {
+                uint32_t ulStart=cClockMicros::now();
+                uint16_t usOut=encode(pucIn, usLength, pucOut);
+
+                _xStats.ulMicros+=cClockMicros::now()-ulStart;
+                _xStats.ulIn+=usLength;
+                _xStats.ulOut+=usOut;
+
+                return usOut;
+            }
+
+
+            /**
+             * End block, output held back bits so the decoder has everything compressed so far
+             *
+             * \param[out] pucOut Pointer to output, at least CCOMPRESS_END_MAX bytes
+             * \return Output length (bytes), 0 when nothing to end
+             */
+            uint16_t end(uint8_t *pucOut) {
+                uint16_t usOut=endBlock(pucOut);
+
+                if (usOut) {
+                    _xStats.ulOut+=usOut;
+                    _xStats.ulBlocks++;
+                }
+
+                return usOut;
+            }
+
+
+            /**
+             * Get compression statistics
+             *
+             * \return Copy of statistics
+             */
+            tCompressStats getStats() const {
+                return _xStats;
+            }
+
+
+            /**
+             * Reset compression statistics
+             */
+            void resetStats() {
+                memset(&_xStats, 0, sizeof(_xStats));
+            }
+
+        protected:
+            /**
+             * Compress bytes, \ref compress
+             *
+             * \param[in] pucIn Pointer to input
+             * \param[in] usLength Input length (bytes)
+             * \param[out] pucOut Pointer to output
+             * \return Output length (bytes)
+             */
+            virtual uint16_t encode(const uint8_t *pucIn, const uint16_t usLength, uint8_t *pucOut) = 0;
+
+
+            /**
+             * End block, \ref end
+             *
+             * \param[out] pucOut Pointer to output
+             * \return Output length (bytes)
+             */
+            virtual uint16_t endBlock(uint8_t *pucOut) = 0;
+
+        protected:
+            tCompressStats      _xStats;
+    }; // class cCompress
+
+
+    /**
+     * A class implementing an LZSS (LZ77) streaming compressor with a small sliding window, heatshrink style.  RAM is the window
+     * plus a few bytes.  Bit stream, most significant bit first:
+     *
+     * 1 + 8 bit literal
+     * 0 + W bit offset back (1 to 2^W-1) + L bit length-2, copy from output history
+     * 0 + W bit offset 0, end of block, skip to next byte boundary
+     *
+     * History is kept across blocks so a lost block breaks decoding until \ref reset on both ends.  Match search follows a
+     * hash chain of earlier positions of the next 2 bytes, nearest first, trying at most CCOMPRESS_LZSS_CHAIN candidates so cost per
+     * byte is bounded whatever W.  Chain links are one byte so with W over 8 only the nearest candidate may be beyond 255 bytes.
+     * RAM is twice the window plus 2^(H+1) bytes; see \ref cCompress::getStats for ratio and CPU cost
+     *
+     * \tparam W Window size bits, 4 to 12
+     * \tparam L Match length bits, 2 to 6
+     * \tparam H Hash head table size bits, 2 to 8
+     */
+    template <uint8_t W = 8, uint8_t L = 4, uint8_t H = 6>
+    class cCompressLZSS : public cCompress {
+        static_assert(W>=4 && W<=12, "cCompressLZSS window bits W must be 4 to 12");
+        static_assert(L>=2 && L<=6, "cCompressLZSS length bits L must be 2 to 6");
+        static_assert(H>=2 && H<=8, "cCompressLZSS hash bits H must be 2 to 8, hash is 8 bit");
+
+        public:
+            /**
+             * Default constructor.  Make stable instance
+             */
+            cCompressLZSS() {
+                reset();
+            }
+
+
+            /**
+             * Clear history and pending bits, decoder must also restart
+             */
+            void reset() {
+                memset(_usHash, 0, sizeof(_usHash));
+                memset(_ucLink, 0, sizeof(_ucLink));
+                _usHead=0;
+                _usFill=0;
+                _usPos=0;
+                _ucLast=0;
+                _ucBits=0;
+                _ucBitCount=0;
+                _bOpen=false;
+            }
+
+        protected:
+            /**
+             * Window size and match lengths
+             */
+            enum {
+                eWINDOW     = 1<<W,
+                eMATCH_MIN  = 2,
+                eMATCH_MAX  = eMATCH_MIN+(1<<L)-1,
+                eHASH       = 1<<H
+            };
+
+
+            /**
+             * Compress bytes, \ref cCompress::compress
+             *
+             * \param[in] pucIn Pointer to input
+             * \param[in] usLength Input length (bytes)
+             * \param[out] pucOut Pointer to output
+             * \return Output length (bytes)
+             */
+            uint16_t encode(const uint8_t *pucIn, const uint16_t usLength, uint8_t *pucOut) {
+                uint16_t usI=0, usO=0, usD, usLimit, usMax, usLen, usBest, usBestD, usCandidate;
+                uint8_t ucChain;
+
+                while(usI<usLength) {
+                    usBest=0;
+                    usBestD=0;
+                    usMax=usLength-usI;
+                    if (usMax>eMATCH_MAX) {
+                        usMax=eMATCH_MAX;
+                    }
+                    usLimit=(_usFill<eWINDOW) ? _usFill : eWINDOW-1;
+
+                    // longest match along hash chain, nearest first, compared as hash may collide.  Source may overlap input
+                    // being matched
+                    if (usMax>=eMATCH_MIN) {
+                        usCandidate=_usHash[hash(pucIn[usI], pucIn[usI+1])];
+                        for(ucChain=0;ucChain<CCOMPRESS_LZSS_CHAIN;ucChain++) {
+                            usD=_usPos-usCandidate;
+                            if (!usD || usD>usLimit) {
+                                break;
+                            }
+                            for(usLen=0;usLen<usMax;usLen++) {
+                                uint8_t ucSrc=(usLen<usD) ? _ucWindow[(_usHead-usD+usLen)&(eWINDOW-1)] : pucIn[usI+usLen-usD];
+
+                                if (ucSrc!=pucIn[usI+usLen]) {
+                                    break;
+                                }
+                            }
+                            if (usLen>usBest) {
+                                usBest=usLen;
+                                usBestD=usD;
+                                if (usBest==usMax) {
+                                    break;
+                                }
+                            }
+                            if (!_ucLink[usCandidate&(eWINDOW-1)]) {
+                                break;
+                            }
+                            usCandidate-=_ucLink[usCandidate&(eWINDOW-1)];
+                        }
+                    }
+
+                    // match only when shorter than literals
+                    if (usBest>=eMATCH_MIN && 1+W+L<9*usBest) {
+                        usO+=bits(&pucOut[usO], 0, 1);
+                        usO+=bits(&pucOut[usO], usBestD, W);
+                        usO+=bits(&pucOut[usO], usBest-eMATCH_MIN, L);
+                    }else {
+                        usBest=1;
+                        usO+=bits(&pucOut[usO], 1, 1);
+                        usO+=bits(&pucOut[usO], pucIn[usI], 8);
+                    }
+
+                    // history
+                    for(usLen=0;usLen<usBest;usLen++) {
+                        link(hash(_ucLast, pucIn[usI]), _usPos-1);
+                        _ucLast=pucIn[usI];
+                        _ucWindow[_usHead]=pucIn[usI++];
+                        _usHead=(_usHead+1)&(eWINDOW-1);
+                        _usPos++;
+                    }
+                    _usFill=(_usFill+usBest<eWINDOW) ? _usFill+usBest : eWINDOW;
+                    _bOpen=true;
+                }
+
+                return usO;
+            }
+
+
+            /**
+             * End block, \ref cCompress::end
+             *
+             * \param[out] pucOut Pointer to output
+             * \return Output length (bytes)
+             */
+            uint16_t endBlock(uint8_t *pucOut) {
+                uint16_t usO=0;
+
+                if (_bOpen) {
+                    usO+=bits(&pucOut[usO], 0, 1);
+                    usO+=bits(&pucOut[usO], 0, W);
+                    if (_ucBitCount) {
+                        pucOut[usO++]=_ucBits<<(8-_ucBitCount);
+                        _ucBits=0;
+                        _ucBitCount=0;
+                    }
+                    _bOpen=false;
+                }
+
+                return usO;
+            }
+
+
+            /**
+             * Add position to hash chain
+             *
+             * \param[in] ucHash Head table index
+             * \param[in] usPosition Stream position of 2 bytes hashed
+             */
+            void link(const uint8_t ucHash, const uint16_t usPosition) {
+                uint16_t usLink=usPosition-_usHash[ucHash];
+
+                _ucLink[usPosition&(eWINDOW-1)]=(usLink<256) ? usLink : 0;
+                _usHash[ucHash]=usPosition;
+            }
+
+
+            /**
+             * Hash 2 bytes for head table
+             *
+             * \param[in] ucA First byte
+             * \param[in] ucB Second byte
+             * \return Head table index
+             */
+            static uint8_t hash(const uint8_t ucA, const uint8_t ucB) {
+                return (ucA*31+ucB)&(eHASH-1);
+            }
+
+
+            /**
+             * Append bits to output
+             *
+             * \param[out] pucOut Pointer to output
+             * \param[in] usValue Value, low ucCount bits used
+             * \param[in] ucCount Bit count, 1 to 16
+             * \return Bytes completed
+             */
+            uint16_t bits(uint8_t *pucOut, const uint16_t usValue, uint8_t ucCount) {
+                uint16_t usO=0;
+
+                while(ucCount--) {
+                    _ucBits=(_ucBits<<1) | ((usValue>>ucCount)&1);
+                    if (8==++_ucBitCount) {
+                        pucOut[usO++]=_ucBits;
+                        _ucBits=0;
+                        _ucBitCount=0;
+                    }
+                }
+
+                return usO;
+            }
+
+        protected:
+            uint8_t             _ucWindow[1<<W];    ///< History
+            uint16_t            _usHash[1<<H];      ///< Last stream position of each 2 byte hash
+            uint8_t             _ucLink[1<<W];      ///< Distance to previous position of same hash or 0, by position
+            uint16_t            _usHead;            ///< Next history write index
+            uint16_t            _usFill;            ///< History valid (bytes)
+            uint16_t            _usPos;             ///< Stream position of next byte, wraps
+            uint8_t             _ucLast;            ///< Last byte added to history
+            uint8_t             _ucBits;            ///< Pending bits
+            uint8_t             _ucBitCount;        ///< Pending bit count
+            bool                _bOpen;             ///< Block has data
+    }; // class cCompressLZSS
+
+} // namespace nText
+
+#endif // compress_h
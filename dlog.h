@@ -0,0 +1,291 @@
+/**
+ * \file
+ * Part of the text handling classes, deferred binary logging.  Log records carry a format ID and raw arguments, formatting is done
+ * by the host (tools/dlog_decode.py)
+ * PROJECT          : FRTOS GCPP
+ * TARGET SYSTEM    : Arduino, Maple Mini
+ */
+
+#ifndef dlog_h
+#define dlog_h
+
+#include "framing.h"
+
+/**
+ * Maximum deferred log record size before framing (bytes), ID and arguments.  Define your own should you wish to change.  The
+ * framed record must fit the TX line, \ref nText::cDLog
+ */
+#if !defined(CDLOG_RECORD_MAX)
+    #define CDLOG_RECORD_MAX     48
+#endif
+
+
+/**
+ * Log a record, the format string is reduced to its ID at compile time and is not held on target
+ *
+ * \param x Logger instance, \ref nText::cDLog
+ * \param f Format string literal, printf style.  One argument per conversion, the host decodes each by its type tag
+ */
+#define DLOG(x, f, ...)     (x).log(nText::tDLogId<nText::dlogId(f)>::usId, ##__VA_ARGS__)
+
+
+namespace nText {
+    /**
+     * Deferred log argument type tags, one nibble per argument in the record.  Signed integers carry their size so the host
+     * formats negatives with %x, %u or %o as the target would
+     */
+    typedef enum {
+        eDLOG_UNSIGNED=0,           ///< Unsigned integer or bool, varint
+        eDLOG_SIGNED8,              ///< 8 bit signed integer, zigzag varint
+        eDLOG_SIGNED16,             ///< 16 bit signed integer, zigzag varint
+        eDLOG_SIGNED32,             ///< 32 bit signed integer, zigzag varint
+        eDLOG_SIGNED64,             ///< 64 bit signed integer, zigzag varint
+        eDLOG_CHAR,                 ///< char, 1 byte
+        eDLOG_FLOAT,                ///< float or double, IEEE754 float 4 bytes little endian
+        eDLOG_STRING                ///< String, length byte and characters
+    }eDLOG;
+
+
+    /**
+     * FNV-1a hash of NULL terminated string, compile time
+     *
+     * \param[in] psc Pointer to string
+     * \param[in] ulHash Hash so far
+     * \return Hash
+     */
+    constexpr uint32_t dlogHash(const char *psc, const uint32_t ulHash=2166136261UL) {
+        return *psc ? dlogHash(psc+1, (ulHash^static_cast<uint8_t>(*psc))*16777619UL) : ulHash;
+    }
+
+
+    /**
+     * Format string ID, 32 bit hash folded to 16 bits.  tools/dlog_decode.py computes the same from sources
+     *
+     * \param[in] psc Pointer to format string
+     * \return ID
+     */
+    constexpr uint16_t dlogId(const char *psc) {
+        return static_cast<uint16_t>((dlogHash(psc)>>16)^(dlogHash(psc)&0xffff));
+    }
+
+
+    /**
+     * Force ID evaluation at compile time, \ref DLOG
+     *
+     * \tparam I ID
+     */
+    template <uint16_t I>
+    struct tDLogId {
+        static const uint16_t usId=I;
+    };
+
+
+    /**
+     * A class implementing deferred binary logging over a TX engine like \ref nFRTOSPeripheral::cUARTTX.  Each record is:
+     *
+     * ID (uint16_t, little endian), argument type tags (\ref eDLOG, 4 bits each, first argument in low nibble, (arguments+1)/2 bytes)
+     * then per argument: integers as varint (signed zigzag), float/double as IEEE754 float (4 bytes, little endian), char as 1 byte,
+     * strings as length byte and characters.  The host decodes by tag so any integer type may be printed with any integer
+     * conversion.  Records are COBS framed, \ref cFramerCOBS, so bytes on the link are record+3 or so rather than the formatted text
+     *
+     * \tparam T TX engine class offering bool transmit(const char*, uint8_t) and eTX_LINE_MAX
+     * \tparam L Maximum record size (bytes), TX line must hold L+L/254+2 so frames are never truncated
+     */
+    template <class T, uint16_t L = CDLOG_RECORD_MAX>
+    class cDLog {
+        static_assert(static_cast<uint16_t>(T::eTX_LINE_MAX)>=L+L/254+2, "cDLog framed record L+L/254+2 must fit TX line, raise N or lower L");
+
+        public:
+            /**
+             * Constructor.  Make stable instance
+             *
+             * \param[in] xTX Reference to TX engine
+             */
+            cDLog(T &xTX) : _xTX(xTX), _ulRecords(0), _ulOverflows(0), _ulFailures(0) { }
+
+
+            /**
+             * Log record, use \ref DLOG so ID is made at compile time
+             *
+             * \param[in] usId Format ID
+             * \param[in] xArgs Arguments
+             * \return Transmit success or failure
+             */
+            template <typename... A>
+            bool log(const uint16_t usId, A... xArgs) {
+                static_assert(2+(sizeof...(A)+1)/2<=L, "cDLog record L too small for argument tags");
+                uint8_t ucRecord[L];
+                uint8_t ucFrame[L+L/254+2];
+                uint16_t usLength=2+(sizeof...(A)+1)/2;
+
+                ucRecord[0]=static_cast<uint8_t>(usId);
+                ucRecord[1]=static_cast<uint8_t>(usId>>8);
+                memset(&ucRecord[2], 0, usLength-2);
+                if (!pack(ucRecord, usLength, 0, xArgs...)) {
+                    _ulOverflows++;
+                    return false;
+                }
+
+                usLength=cFramerCOBS::encode(ucFrame, sizeof(ucFrame), ucRecord, usLength);
+                if (!_xTX.transmit(reinterpret_cast<const char*>(ucFrame), static_cast<uint8_t>(usLength))) {
+                    _ulFailures++;
+                    return false;
+                }
+                _ulRecords++;
+
+                return true;
+            }
+
+
+            /**
+             * Get records logged, transmitted successfully
+             *
+             * \return Count
+             */
+            uint32_t getRecords() const {
+                return _ulRecords;
+            }
+
+
+            /**
+             * Get records not logged, arguments exceeded L
+             *
+             * \return Count
+             */
+            uint32_t getOverflows() const {
+                return _ulOverflows;
+            }
+
+
+            /**
+             * Get records not logged, transmit failed e.g. TX queue full
+             *
+             * \return Count
+             */
+            uint32_t getFailures() const {
+                return _ulFailures;
+            }
+
+        protected:
+            /**
+             * Pack arguments, recursion end
+             *
+             * \return Success
+             */
+            static bool pack(uint8_t *, uint16_t &, const uint8_t) {
+                return true;
+            }
+
+
+            /**
+             * Pack arguments
+             *
+             * \param[out] pucRecord Pointer to record
+             * \param[in,out] usLength Record length (bytes)
+             * \param[in] ucArg Argument index, for its type tag
+             * \param[in] xArg First argument
+             * \param[in] xArgs Remaining arguments
+             * \return Success, false when record full
+             */
+            template <typename A, typename... R>
+            static bool pack(uint8_t *pucRecord, uint16_t &usLength, const uint8_t ucArg, A xArg, R... xArgs) {
+                pucRecord[2+ucArg/2]|=tag(xArg)<<((ucArg&1)*4);
+
+                return put(pucRecord, usLength, xArg) && pack(pucRecord, usLength, ucArg+1, xArgs...);
+            }
+
+
+            /**
+             * Put unsigned varint, 7 bits per byte least significant first, top bit set on all but last
+             *
+             * \param[out] pucRecord Pointer to record
+             * \param[in,out] usLength Record length (bytes)
+             * \param[in] xValue Value
+             * \return Success, false when record full
+             */
+            template <typename U>
+            static bool varint(uint8_t *pucRecord, uint16_t &usLength, U xValue) {
+                do {
+                    if (usLength>=L) {
+                        return false;
+                    }
+                    pucRecord[usLength++]=static_cast<uint8_t>(xValue&0x7f) | (xValue>0x7f ? 0x80 : 0x00);
+                    xValue>>=7;
+                }while(xValue);
+
+                return true;
+            }
+
+
+            /**
+             * Put bytes
+             *
+             * \param[out] pucRecord Pointer to record
+             * \param[in,out] usLength Record length (bytes)
+             * \param[in] pucData Pointer to bytes
+             * \param[in] usCount Byte count
+             * \return Success, false when record full
+             */
+            static bool bytes(uint8_t *pucRecord, uint16_t &usLength, const uint8_t *pucData, const uint16_t usCount) {
+                if (usLength+usCount>L) {
+                    return false;
+                }
+                memcpy(&pucRecord[usLength], pucData, usCount);
+                usLength+=usCount;
+
+                return true;
+            }
+
+
+            // argument types, signed integers zigzag so small negatives are short
+            static bool put(uint8_t *puc, uint16_t &us, const signed char x) { return varint(puc, us, static_cast<uint16_t>((x<<1)^(x>>7))); }
+            static bool put(uint8_t *puc, uint16_t &us, const short x) { return varint(puc, us, static_cast<uint32_t>((static_cast<int32_t>(x)<<1)^(x>>15))); }
+            static bool put(uint8_t *puc, uint16_t &us, const int x) { return put(puc, us, static_cast<long>(x)); }
+            static bool put(uint8_t *puc, uint16_t &us, const long x) { return varint(puc, us, (static_cast<unsigned long>(x)<<1)^static_cast<unsigned long>(x>>(sizeof(long)*8-1))); }
+            static bool put(uint8_t *puc, uint16_t &us, const long long x) { return varint(puc, us, (static_cast<unsigned long long>(x)<<1)^static_cast<unsigned long long>(x>>63)); }
+            static bool put(uint8_t *puc, uint16_t &us, const unsigned char x) { return varint(puc, us, x); }
+            static bool put(uint8_t *puc, uint16_t &us, const unsigned short x) { return varint(puc, us, x); }
+            static bool put(uint8_t *puc, uint16_t &us, const unsigned int x) { return varint(puc, us, x); }
+            static bool put(uint8_t *puc, uint16_t &us, const unsigned long x) { return varint(puc, us, x); }
+            static bool put(uint8_t *puc, uint16_t &us, const unsigned long long x) { return varint(puc, us, x); }
+            static bool put(uint8_t *puc, uint16_t &us, const bool x) { return varint(puc, us, static_cast<uint8_t>(x)); }
+            static bool put(uint8_t *puc, uint16_t &us, const char x) { return bytes(puc, us, reinterpret_cast<const uint8_t*>(&x), 1); }
+            static bool put(uint8_t *puc, uint16_t &us, const double x) { return put(puc, us, static_cast<float>(x)); }
+            static bool put(uint8_t *puc, uint16_t &us, const float x) { return bytes(puc, us, reinterpret_cast<const uint8_t*>(&x), 4); }
+            static bool put(uint8_t *puc, uint16_t &us, const char *psc) {
+                size_t l=psc ? strlen(psc) : 0;
+                uint8_t ucLength=static_cast<uint8_t>(l>0xff ? 0xff : l);
+
+                return bytes(puc, us, &ucLength, 1) && (!ucLength || bytes(puc, us, reinterpret_cast<const uint8_t*>(psc), ucLength));
+            }
+
+
+            // argument type tags, \ref eDLOG
+            template <typename S>
+            static uint8_t signedTag() { return (1==sizeof(S)) ? eDLOG_SIGNED8 : (2==sizeof(S)) ? eDLOG_SIGNED16 : (4==sizeof(S)) ? eDLOG_SIGNED32 : eDLOG_SIGNED64; }
+            static uint8_t tag(const signed char) { return eDLOG_SIGNED8; }
+            static uint8_t tag(const short) { return signedTag<short>(); }
+            static uint8_t tag(const int) { return signedTag<int>(); }
+            static uint8_t tag(const long) { return signedTag<long>(); }
+            static uint8_t tag(const long long) { return eDLOG_SIGNED64; }
+            static uint8_t tag(const unsigned char) { return eDLOG_UNSIGNED; }
+            static uint8_t tag(const unsigned short) { return eDLOG_UNSIGNED; }
+            static uint8_t tag(const unsigned int) { return eDLOG_UNSIGNED; }
+            static uint8_t tag(const unsigned long) { return eDLOG_UNSIGNED; }
+            static uint8_t tag(const unsigned long long) { return eDLOG_UNSIGNED; }
+            static uint8_t tag(const bool) { return eDLOG_UNSIGNED; }
+            static uint8_t tag(const char) { return eDLOG_CHAR; }
+            static uint8_t tag(const double) { return eDLOG_FLOAT; }
+            static uint8_t tag(const float) { return eDLOG_FLOAT; }
+            static uint8_t tag(const char *) { return eDLOG_STRING; }
+
+        protected:
+            T&                  _xTX;
+            uint32_t            _ulRecords;
+            uint32_t            _ulOverflows;
+            uint32_t            _ulFailures;
+    }; // class cDLog
+
+} // namespace nText
+
+#endif // dlog_h
@@ -0,0 +1,807 @@
+/**
+ * \file
+ * Part of the text handling classes, framing engines used by \ref nText::cTexter to find frames (lines) in a character stream
+ * PROJECT          : FRTOS GCPP
+ * TARGET SYSTEM    : Arduino, Maple Mini
+ */
+
+#ifndef framing_h
+#define framing_h
+
+namespace nText {
+    /**
+     * Framer actions, returned by framing engine feed method as a combination of flags.  A framing engine is any class offering:
+     *
+     * uint8_t feed(const uint8_t ucIn, uint8_t &ucOut) - process one received byte, return \ref eFRAME flags
+     * uint8_t idle() - no bytes available, return \ref eFRAME flags (eFRAME_END for time based framing)
+     * void received(const uint16_t usCount) - usCount bytes were just read from the device and will be fed next (timestamps for
+     * time based framing)
+     * void reset() - drop partial frame state
+     */
+    typedef enum {
+        eFRAME_NONE         = 0x00,     ///< Byte consumed, nothing to store
+        eFRAME_STORE        = 0x01,     ///< Store output byte in frame
+        eFRAME_END          = 0x02,     ///< Frame complete
+        eFRAME_ERROR        = 0x04,     ///< Frame malformed, discard it
+        eFRAME_HOLD         = 0x08,     ///< Byte not consumed, feed it again (start of next frame)
+    }eFRAME;
+
+
+    /**
+     * Bulk feed a framing engine from a buffer until a frame completes or input is exhausted
+     *
+     * \tparam F Framing engine class
+     * \param[in,out] xFramer Framing engine instance
+     * \param[in] pucIn Pointer to received bytes
+     * \param[in] usLength Received byte count
+     * \param[out] pucOut Pointer to frame buffer
+     * \param[in,out] usOutLength Frame length so far (bytes), updated as bytes are stored
+     * \param[in] usOutMax Frame buffer size (bytes), bytes beyond this are dropped
+     * \param[out] bEnd Frame complete state
+     * \return Bytes consumed from pucIn
+     */
+    template <class F>
+    uint16_t frameFeed(F &xFramer, const uint8_t *pucIn, const uint16_t usLength, uint8_t *pucOut, uint16_t &usOutLength, const uint16_t usOutMax, bool &bEnd) {
+        uint16_t usI=0;
+        uint8_t ucOut, ucAction;
+
+        bEnd=false;
+        while(usI<usLength && !bEnd) {
+            ucAction=xFramer.feed(pucIn[usI], ucOut);
+            if (!(ucAction & eFRAME_HOLD)) {
+                usI++;
+            }
+            if (ucAction & eFRAME_ERROR) {
+                usOutLength=0;
+            }
+            if ((ucAction & eFRAME_STORE) && usOutLength<usOutMax) {
+                pucOut[usOutLength++]=ucOut;
+            }
+            if ((ucAction & eFRAME_END) && usOutLength) {
+                bEnd=true;
+            }
+        }
+
+        return usI;
+    }
+
+
+    /**
+     * Framing engine for "\r\n" terminated text lines, the terminator is kept as part of the line.  Original \ref cTexter behaviour
+     */
+    class cFramerCRLF {
+        public:
+            cFramerCRLF() : _ucLast(0) { }
+
+
+            /**
+             * Process received byte
+             *
+             * \param[in] ucIn Received byte
+             * \param[out] ucOut Byte to store
+             * \return \ref eFRAME flags
+             */
+            uint8_t feed(const uint8_t ucIn, uint8_t &ucOut) {
+                uint8_t ucAction=eFRAME_STORE;
+
+                ucOut=ucIn;
+                if (ucIn=='\n' && _ucLast=='\r') {
+                    ucAction|=eFRAME_END;
+                }
+                _ucLast=(ucAction & eFRAME_END) ? 0 : ucIn;
+
+                return ucAction;
+            }
+
+
+            /**
+             * No bytes available
+             *
+             * \return \ref eFRAME flags, always eFRAME_NONE
+             */
+            uint8_t idle() {
+                return eFRAME_NONE;
+            }
+
+
+            /**
+             * Bytes read from device in one go, about to be fed
+             *
+             * \param[in] usCount Byte count
+             */
+            void received(const uint16_t usCount) {
+                (void)usCount;
+            }
+
+
+            /**
+             * Drop partial frame state
+             */
+            void reset() {
+                _ucLast=0;
+            }
+
+        protected:
+            uint8_t     _ucLast;        ///< Previous byte
+    }; // class cFramerCRLF
+
+
+    /**
+     * Maximum characters in a terminator set of \ref cFramerTerminator.  Define your own should you wish to change
+     */
+#if !defined(CFRAMERTERMINATOR_MAX)
+    #define CFRAMERTERMINATOR_MAX    4
+#endif
+
+
+    /**
+     * Framing engine for text lines ended by any character of a terminator set, default "\n".  Terminators are not stored and
+     * empty lines are ignored, so "\r\n" with set "\r\n" gives one line
+     */
+    class cFramerTerminator {
+        public:
+            cFramerTerminator() : _ucCount(1), _bData(false) {
+                _ucTerminator[0]='\n';
+            }
+
+
+            /**
+             * Set terminator characters
+             *
+             * \param[in] pscSet Null terminated character string of terminators, truncated to \ref CFRAMERTERMINATOR_MAX
+             */
+            void setTerminators(const char *pscSet) {
+                for(_ucCount=0;pscSet[_ucCount] && _ucCount<CFRAMERTERMINATOR_MAX;_ucCount++) {
+                    _ucTerminator[_ucCount]=static_cast<uint8_t>(pscSet[_ucCount]);
+                }
+            }
+
+
+            /**
+             * Process received byte
+             *
+             * \param[in] ucIn Received byte
+             * \param[out] ucOut Byte to store
+             * \return \ref eFRAME flags
+             */
+            uint8_t feed(const uint8_t ucIn, uint8_t &ucOut) {
+                uint8_t ucI;
+
+                for(ucI=0;ucI<_ucCount;ucI++) {
+                    if (ucIn==_ucTerminator[ucI]) {
+                        // empty line?  ignore it
+                        if (!_bData) {
+                            return eFRAME_NONE;
+                        }
+                        _bData=false;
+                        return eFRAME_END;
+                    }
+                }
+                ucOut=ucIn;
+                _bData=true;
+
+                return eFRAME_STORE;
+            }
+
+
+            /**
+             * No bytes available
+             *
+             * \return \ref eFRAME flags, always eFRAME_NONE
+             */
+            uint8_t idle() {
+                return eFRAME_NONE;
+            }
+
+
+            /**
+             * Bytes read from device in one go, about to be fed
+             *
+             * \param[in] usCount Byte count
+             */
+            void received(const uint16_t usCount) {
+                (void)usCount;
+            }
+
+
+            /**
+             * Drop partial frame state
+             */
+            void reset() {
+                _bData=false;
+            }
+
+        protected:
+            uint8_t     _ucTerminator[CFRAMERTERMINATOR_MAX];
+            uint8_t     _ucCount;       ///< Terminators in set
+            bool        _bData;         ///< Frame has data state
+    }; // class cFramerTerminator
+
+
+    /**
+     * Framing engine for SLIP (RFC 1055) binary frames
+     */
+    class cFramerSLIP {
+        public:
+            /**
+             * SLIP special characters
+             */
+            typedef enum {
+                eSLIP_END           = 0xC0,
+                eSLIP_ESC           = 0xDB,
+                eSLIP_ESC_END       = 0xDC,
+                eSLIP_ESC_ESC       = 0xDD,
+            }eSLIP;
+
+
+            cFramerSLIP() : _bEscape(false), _bData(false) { }
+
+
+            /**
+             * Process received byte
+             *
+             * \param[in] ucIn Received byte
+             * \param[out] ucOut Byte to store
+             * \return \ref eFRAME flags
+             */
+            uint8_t feed(const uint8_t ucIn, uint8_t &ucOut) {
+                uint8_t ucAction=eFRAME_STORE;
+
+                if (eSLIP_END==ucIn) {
+                    // escaped delimiter is an error otherwise frame is done, empty frames ignored
+                    if (_bEscape) {
+                        ucAction=eFRAME_ERROR;
+                    }else {
+                        ucAction=_bData ? eFRAME_END : eFRAME_NONE;
+                    }
+                    reset();
+                }else if (_bEscape) {
+                    _bEscape=false;
+                    if (eSLIP_ESC_END==ucIn) {
+                        ucOut=eSLIP_END;
+                    }else if (eSLIP_ESC_ESC==ucIn) {
+                        ucOut=eSLIP_ESC;
+                    }else {
+                        ucOut=ucIn;     // protocol violation, RFC says leave byte in packet
+                    }
+                    _bData=true;
+                }else if (eSLIP_ESC==ucIn) {
+                    _bEscape=true;
+                    ucAction=eFRAME_NONE;
+                }else {
+                    ucOut=ucIn;
+                    _bData=true;
+                }
+
+                return ucAction;
+            }
+
+
+            /**
+             * No bytes available
+             *
+             * \return \ref eFRAME flags, always eFRAME_NONE
+             */
+            uint8_t idle() {
+                return eFRAME_NONE;
+            }
+
+
+            /**
+             * Bytes read from device in one go, about to be fed
+             *
+             * \param[in] usCount Byte count
+             */
+            void received(const uint16_t usCount) {
+                (void)usCount;
+            }
+
+
+            /**
+             * Drop partial frame state
+             */
+            void reset() {
+                _bEscape=false;
+                _bData=false;
+            }
+
+
+            /**
+             * Encode a complete frame, leading and trailing END characters are added
+             *
+             * \param[out] pucOut Pointer to encoded frame buffer, worst case usLength*2+2 bytes
+             * \param[in] usOutMax Encoded frame buffer size (bytes)
+             * \param[in] pucIn Pointer to frame data
+             * \param[in] usLength Frame data length (bytes)
+             * \return Encoded length (bytes), 0 when pucOut too small
+             */
+            static uint16_t encode(uint8_t *pucOut, const uint16_t usOutMax, const uint8_t *pucIn, const uint16_t usLength) {
+                uint16_t usI, usO=0;
+
+                if (usOutMax<2) {
+                    return 0;
+                }
+                pucOut[usO++]=eSLIP_END;
+                for(usI=0;usI<usLength;usI++) {
+                    if (usO+3>usOutMax) {
+                        return 0;
+                    }
+                    if (eSLIP_END==pucIn[usI]) {
+                        pucOut[usO++]=eSLIP_ESC;
+                        pucOut[usO++]=eSLIP_ESC_END;
+                    }else if (eSLIP_ESC==pucIn[usI]) {
+                        pucOut[usO++]=eSLIP_ESC;
+                        pucOut[usO++]=eSLIP_ESC_ESC;
+                    }else {
+                        pucOut[usO++]=pucIn[usI];
+                    }
+                }
+                pucOut[usO++]=eSLIP_END;
+
+                return usO;
+            }
+
+        protected:
+            bool        _bEscape;       ///< Escape character received state
+            bool        _bData;         ///< Frame has data state
+    }; // class cFramerSLIP
+
+
+    /**
+     * Framing engine for COBS (Consistent Overhead Byte Stuffing) binary frames, delimited by 0x00
+     */
+    class cFramerCOBS {
+        public:
+            cFramerCOBS() : _ucRemaining(0), _bZero(false), _bData(false) { }
+
+
+            /**
+             * Process received byte
+             *
+             * \param[in] ucIn Received byte
+             * \param[out] ucOut Byte to store
+             * \return \ref eFRAME flags
+             */
+            uint8_t feed(const uint8_t ucIn, uint8_t &ucOut) {
+                uint8_t ucAction=eFRAME_NONE;
+
+                if (0x00==ucIn) {
+                    // delimiter, block cut short is an error otherwise frame is done.  final block implicit zero is dropped
+                    if (_ucRemaining) {
+                        ucAction=eFRAME_ERROR;
+                    }else if (_bData) {
+                        ucAction=eFRAME_END;
+                    }
+                    reset();
+                }else if (!_ucRemaining) {
+                    // code byte, previous block implies a zero?
+                    if (_bZero) {
+                        ucOut=0x00;
+                        ucAction=eFRAME_STORE;
+                    }
+                    _ucRemaining=ucIn-1;
+                    _bZero=(0xFF!=ucIn);
+                    _bData=true;
+                }else {
+                    ucOut=ucIn;
+                    ucAction=eFRAME_STORE;
+                    _ucRemaining--;
+                }
+
+                return ucAction;
+            }
+
+
+            /**
+             * No bytes available
+             *
+             * \return \ref eFRAME flags, always eFRAME_NONE
+             */
+            uint8_t idle() {
+                return eFRAME_NONE;
+            }
+
+
+            /**
+             * Bytes read from device in one go, about to be fed
+             *
+             * \param[in] usCount Byte count
+             */
+            void received(const uint16_t usCount) {
+                (void)usCount;
+            }
+
+
+            /**
+             * Drop partial frame state
+             */
+            void reset() {
+                _ucRemaining=0;
+                _bZero=false;
+                _bData=false;
+            }
+
+
+            /**
+             * Encode a complete frame, trailing 0x00 delimiter is added
+             *
+             * \param[out] pucOut Pointer to encoded frame buffer, worst case usLength+usLength/254+2 bytes
+             * \param[in] usOutMax Encoded frame buffer size (bytes)
+             * \param[in] pucIn Pointer to frame data
+             * \param[in] usLength Frame data length (bytes)
+             * \return Encoded length (bytes) including delimiter, 0 when pucOut too small
+             */
+            static uint16_t encode(uint8_t *pucOut, const uint16_t usOutMax, const uint8_t *pucIn, const uint16_t usLength) {
+                uint16_t usI, usCode=0, usO=1;
+                uint8_t ucCode=1;
+
+                if (usOutMax<2) {
+                    return 0;
+                }
+                for(usI=0;usI<usLength;usI++) {
+                    // room for this byte and delimiter?
+                    if (usO+2>usOutMax) {
+                        return 0;
+                    }
+                    if (0x00!=pucIn[usI]) {
+                        pucOut[usO++]=pucIn[usI];
+                        ucCode++;
+                    }
+                    // block ended by zero or maximum length, start another
+                    if (0x00==pucIn[usI] || 0xFF==ucCode) {
+                        if (usO+2>usOutMax) {
+                            return 0;
+                        }
+                        pucOut[usCode]=ucCode;
+                        usCode=usO++;
+                        ucCode=1;
+                    }
+                }
+                pucOut[usCode]=ucCode;
+                pucOut[usO++]=0x00;
+
+                return usO;
+            }
+
+
+            /**
+             * Decode a complete frame, without trailing 0x00 delimiter
+             *
+             * \param[out] pucOut Pointer to decoded frame buffer, worst case usLength bytes
+             * \param[in] usOutMax Decoded frame buffer size (bytes)
+             * \param[in] pucIn Pointer to encoded frame
+             * \param[in] usLength Encoded frame length (bytes)
+             * \return Decoded length (bytes), 0 when malformed or pucOut too small
+             */
+            static uint16_t decode(uint8_t *pucOut, const uint16_t usOutMax, const uint8_t *pucIn, const uint16_t usLength) {
+                cFramerCOBS xFramer;
+                uint16_t usI, usO=0;
+                uint8_t ucOut, ucAction;
+
+                // frame then delimiter, unlike frameFeed output is never truncated
+                for(usI=0;usI<=usLength;usI++) {
+                    ucAction=xFramer.feed((usI<usLength) ? pucIn[usI] : 0x00, ucOut);
+                    if (ucAction & eFRAME_ERROR) {
+                        return 0;
+                    }
+                    if (ucAction & eFRAME_STORE) {
+                        if (usO>=usOutMax) {
+                            return 0;
+                        }
+                        pucOut[usO++]=ucOut;
+                    }
+                    if (ucAction & eFRAME_END) {
+                        return (usI==usLength) ? usO : 0;
+                    }
+                }
+
+                return 0;
+            }
+
+        protected:
+            uint8_t     _ucRemaining;   ///< Data bytes remaining in block
+            bool        _bZero;         ///< Block ends with implicit zero state
+            bool        _bData;         ///< Frame has data state
+    }; // class cFramerCOBS
+
+
+    /**
+     * Framing engine for length prefixed binary frames, big endian length of W bytes then data.  Zero length frames are ignored
+     *
+     * \tparam W Length prefix width (bytes), 1 or 2
+     */
+    template <uint8_t W = 1>
+    class cFramerLength {
+        static_assert(1==W || 2==W, "cFramerLength W must be 1 or 2");
+
+        public:
+            cFramerLength() : _usRemaining(0), _ucHeader(0) { }
+
+
+            /**
+             * Process received byte
+             *
+             * \param[in] ucIn Received byte
+             * \param[out] ucOut Byte to store
+             * \return \ref eFRAME flags
+             */
+            uint8_t feed(const uint8_t ucIn, uint8_t &ucOut) {
+                uint8_t ucAction=eFRAME_NONE;
+
+                if (_ucHeader<W) {
+                    _usRemaining=(_usRemaining<<8) | ucIn;
+                    // header complete but empty frame?  start again
+                    if (++_ucHeader==W && !_usRemaining) {
+                        _ucHeader=0;
+                    }
+                }else {
+                    ucOut=ucIn;
+                    ucAction=eFRAME_STORE;
+                    if (!--_usRemaining) {
+                        ucAction|=eFRAME_END;
+                        _ucHeader=0;
+                    }
+                }
+
+                return ucAction;
+            }
+
+
+            /**
+             * No bytes available
+             *
+             * \return \ref eFRAME flags, always eFRAME_NONE
+             */
+            uint8_t idle() {
+                return eFRAME_NONE;
+            }
+
+
+            /**
+             * Bytes read from device in one go, about to be fed
+             *
+             * \param[in] usCount Byte count
+             */
+            void received(const uint16_t usCount) {
+                (void)usCount;
+            }
+
+
+            /**
+             * Drop partial frame state
+             */
+            void reset() {
+                _usRemaining=0;
+                _ucHeader=0;
+            }
+
+
+            /**
+             * Encode length prefix header
+             *
+             * \param[out] pucOut Pointer to header buffer, W bytes
+             * \param[in] usLength Frame data length (bytes)
+             * \return Header length (bytes)
+             */
+            static uint8_t encode(uint8_t *pucOut, const uint16_t usLength) {
+                uint8_t ucI;
+
+                for(ucI=0;ucI<W;ucI++) {
+                    pucOut[ucI]=static_cast<uint8_t>(usLength>>(8*(W-1-ucI)));
+                }
+
+                return W;
+            }
+
+        protected:
+            uint16_t    _usRemaining;   ///< Data bytes remaining, while in header the length so far
+            uint8_t     _ucHeader;      ///< Header bytes received
+    }; // class cFramerLength
+
+
+    /**
+     * Clock for time based framing engines, Arduino micros().  Replace with a simulated clock class offering the same static
+     * method for host testing
+     */
+    class cClockMicros {
+        public:
+            /**
+             * Get time
+             *
+             * \return Time (microseconds), wraps
+             */
+            static uint32_t now() {
+                return micros();
+            }
+    }; // class cClockMicros
+
+
+    /**
+     * Framing engine for frames delimited by line silence, e.g. Modbus RTU 3.5 character times.  Bytes are timestamped per device
+     * read, \ref received: the last byte of a read arrived no later than the read and those before it are taken as back to back
+     * at one character time each.  Silence inside a single read can not be seen, so the receive task must read at least once per
+     * gap, e.g. signalled from the RX interrupt or adaptive polling with a minimum delay of 0.  A gap seen when the next read's
+     * first byte is fed closes the frame before it, when no bytes are available \ref idle closes it.  Bytes fed without
+     * \ref received are timestamped as they are framed.  \ref idle runs only when the receive task wakes, so with
+     * \ref nFRTOSPeripheral::eRXMODE_EVENT the RX delay must be non-zero or the last frame waits for further bytes
+     *
+     * \tparam C Clock class with static uint32_t now() in microseconds, default \ref cClockMicros
+     */
+    template <class C = cClockMicros>
+    class cFramerGap {
+        public:
+            /**
+             * Gap statistics, \ref getStats.  Inter-byte gaps are within frames and estimated from read times, \ref received, so bytes
+             * of one read count one character time.  Jitter is ulGapMax-ulGapMin
+             */
+            typedef struct {
+                uint32_t        ulFrames;           ///< Frames closed
+                uint32_t        ulGaps;             ///< Inter-byte gaps measured
+                uint32_t        ulGapMin;           ///< Minimum inter-byte gap (microseconds)
+                uint32_t        ulGapMax;           ///< Maximum inter-byte gap (microseconds)
+                uint32_t        ulGapSum;           ///< Sum of inter-byte gaps for mean (microseconds, wraps)
+                uint32_t        ulCloseMax;         ///< Maximum frame closing gap (microseconds)
+            }tGapStats;
+
+
+            cFramerGap() : _ulGap(1750UL), _ulCharacter(500UL), _ulLast(0), _ulRead(0), _usRead(0), _bData(false) {
+                resetStats();
+            }
+
+
+            /**
+             * Set frame gap from baud rate
+             *
+             * \param[in] ulBaud Baud rate (bits per second)
+             * \param[in] ucBitsPerCharacter Bits per character including start, parity and stop bits.  Default 11 (Modbus RTU)
+             * \param[in] ucGapTenths Gap in tenths of a character time.  Default 35 (3.5 characters)
+             */
+            void setBaud(const uint32_t ulBaud, const uint8_t ucBitsPerCharacter=11, const uint8_t ucGapTenths=35) {
+                _ulGap=(100000UL*ucBitsPerCharacter*ucGapTenths)/ulBaud;
+                _ulCharacter=(1000000UL*ucBitsPerCharacter)/ulBaud;
+            }
+
+
+            /**
+             * Set frame gap
+             *
+             * \param[in] ulGap Gap (microseconds)
+             * \param[in] ulCharacter Character time (microseconds), back to back byte spacing within a read.  Default 0, ulGap/3.5
+             */
+            void setGap(const uint32_t ulGap, const uint32_t ulCharacter=0) {
+                _ulGap=ulGap;
+                _ulCharacter=ulCharacter ? ulCharacter : (ulGap*2)/7;
+            }
+
+
+            /**
+             * Process received byte
+             *
+             * \param[in] ucIn Received byte
+             * \param[out] ucOut Byte to store
+             * \return \ref eFRAME flags
+             */
+            uint8_t feed(const uint8_t ucIn, uint8_t &ucOut) {
+                uint32_t ulNow, ulGap;
+
+                // arrival estimate, bytes of a read end at the read time
+                if (_usRead) {
+                    ulNow=_ulRead-(_usRead-1)*_ulCharacter;
+                }else {
+                    ulNow=C::now();
+                }
+                ulGap=ulNow-_ulLast;
+                if (static_cast<int32_t>(ulGap)<0) {
+                    ulGap=0;
+                    ulNow=_ulLast;
+                }
+
+                if (_bData) {
+                    // silence before this byte?  close frame and feed byte again as start of next
+                    if (ulGap>=_ulGap) {
+                        frameClosed(ulGap);
+                        return eFRAME_END | eFRAME_HOLD;
+                    }
+
+                    _xStats.ulGaps++;
+                    _xStats.ulGapSum+=ulGap;
+                    if (ulGap<_xStats.ulGapMin) {
+                        _xStats.ulGapMin=ulGap;
+                    }
+                    if (ulGap>_xStats.ulGapMax) {
+                        _xStats.ulGapMax=ulGap;
+                    }
+                }
+                _ulLast=ulNow;
+                _bData=true;
+                ucOut=ucIn;
+                if (_usRead) {
+                    _usRead--;
+                }
+
+                return eFRAME_STORE;
+            }
+
+
+            /**
+             * Bytes read from device in one go, timestamps the read
+             *
+             * \param[in] usCount Byte count
+             */
+            void received(const uint16_t usCount) {
+                _ulRead=C::now();
+                _usRead=usCount;
+            }
+
+
+            /**
+             * No bytes available, close frame when silent for the gap
+             *
+             * \return \ref eFRAME flags
+             */
+            uint8_t idle() {
+                uint32_t ulGap=C::now()-_ulLast;
+
+                _usRead=0;
+                if (_bData && ulGap>=_ulGap) {
+                    frameClosed(ulGap);
+                    return eFRAME_END;
+                }
+
+                return eFRAME_NONE;
+            }
+
+
+            /**
+             * Drop partial frame state
+             */
+            void reset() {
+                _bData=false;
+            }
+
+
+            /**
+             * Get gap statistics
+             *
+             * \return Copy of statistics
+             */
+            tGapStats getStats() const {
+                return _xStats;
+            }
+
+
+            /**
+             * Reset gap statistics
+             */
+            void resetStats() {
+                memset(&_xStats, 0, sizeof(_xStats));
+                _xStats.ulGapMin=0xFFFFFFFFUL;
+            }
+
+        protected:
+            /**
+             * Frame closed by silence
+             *
+             * \param[in] ulGap Closing gap (microseconds)
+             */
+            void frameClosed(const uint32_t ulGap) {
+                _bData=false;
+                _xStats.ulFrames++;
+                if (ulGap>_xStats.ulCloseMax) {
+                    _xStats.ulCloseMax=ulGap;
+                }
+            }
+
+        protected:
+            uint32_t    _ulGap;         ///< Frame gap (microseconds)
+            uint32_t    _ulCharacter;   ///< Character time (microseconds)
+            uint32_t    _ulLast;        ///< Last byte timestamp (microseconds)
+            uint32_t    _ulRead;        ///< Last read timestamp (microseconds)
+            uint16_t    _usRead;        ///< Bytes of last read not yet fed
+            bool        _bData;         ///< Frame has data state
+            tGapStats   _xStats;
+    }; // class cFramerGap
+
+} // namespace nText
+
+#endif // framing_h
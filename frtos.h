@@ -54,6 +54,19 @@ namespace nFRTOS {
             }
 
 
+#if defined(INCLUDE_uxTaskGetStackHighWaterMark) && (INCLUDE_uxTaskGetStackHighWaterMark==1)
+            /**
+             * Get task stack high water mark, the minimum free stack space there has been since the task started
+             *
+             * \attention FRTOS configuration must set INCLUDE_uxTaskGetStackHighWaterMark to 1 if this API is required
+             * \return Free stack (words, not Bytes)
+             */
+            UBaseType_t getStackHighWaterMark() const {
+                return uxTaskGetStackHighWaterMark(_xTHandle);
+            }
+#endif
+
+
             /**
              * Suspend task
              *
@@ -86,6 +99,30 @@ namespace nFRTOS {
             }
 
 
+            /**
+             * Give this task a notification, increments its notification count.  Task context only
+             *
+             * \return Notify state
+             */
+            bool notifyGive() {
+                return (pdPASS == xTaskNotifyGive(_xTHandle));
+            }
+
+
+            /**
+             * Give this task a notification from an ISR, increments its notification count.  Requests a context switch
+             * when the task is of higher priority than the interrupted task
+             */
+            void notifyGiveFromISR() {
+                BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+                vTaskNotifyGiveFromISR(_xTHandle, &xHigherPriorityTaskWoken);
+#if !defined(ARDUINO_ARCH_AVR)
+                portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+#endif
+            }
+
+
 #if defined(ARDUINO_SAM_DUE) && defined(FRTOS_SAM_CONTROL)
             /**
              * Tasking stop.  Specific Arduino Atmal91SAM implementation where a global in the framework is used to control interrupt driven task switching.
@@ -154,6 +191,17 @@ namespace nFRTOS {
             virtual void run() = 0;
 
 
+            /**
+             * Wait for notification given to this task, \ref notifyGive.  Invoke from within \see run() only
+             *
+             * \param[in] xTicksToWait Ticks to wait.  Default portMAX_DELAY (unlimited)
+             * \return Notification count before being cleared, 0 when xTicksToWait expired
+             */
+            uint32_t notifyTake(const TickType_t xTicksToWait=portMAX_DELAY) const {
+                return ulTaskNotifyTake(pdTRUE, xTicksToWait);
+            }
+
+
             /**
              * Task callback handler, invokes user defined \see run() method
              *
@@ -253,6 +301,16 @@ namespace nFRTOS {
             }
 
 
+            /**
+             * Get queue elements waiting to be received
+             *
+             * \return Elements waiting
+             */
+            UBaseType_t getMessagesWaiting() const {
+                return uxQueueMessagesWaiting( _xQHandle );
+            }
+
+
             /**
              * Peek at data on queue.  If xTicksToWait expires and no data received bReceived will be false
              *
@@ -264,7 +322,7 @@ namespace nFRTOS {
                 QType xData;
 
                 bReceived=false;
-                 if (pdTRUE == xQueuePeek(_xQHandle, static_cast<void *>(xData), xTicksToWait)) {
+                 if (pdTRUE == xQueuePeek(_xQHandle, static_cast<void *>(&xData), xTicksToWait)) {
                     bReceived=true;
                 }
 
@@ -8,25 +8,100 @@
 #ifndef frtosperipheral_h
 #define frtosperipheral_h
 
+#include "compress.h"
 #include "text.h"
 #include "frtos_ext.h"
 
 namespace nFRTOSPeripheral {
+/*! \cond PRIVATE */
     /**
-     * A class to read complete text lines that is FRTOS task friendly sourced from Arduino hardware UARTs built upon observer design pattern and queues
+     * Spare line buffers of \ref cUARTRX, buffer 0 is the receiver itself so there are D-1
      *
      * \tparam N Text line length (characters, including NULL)
+     * \tparam D Line buffers
+     */
+    template <uint16_t N, uint8_t D>
+    struct tLineSpare {
+        nText::cTextLine<N>     xLine[D-1];
+
+        nText::cTextLine<N> *get(const uint8_t ucIndex) {
+            return &xLine[ucIndex-1];
+        }
+    };
+
+
+    /**
+     * Single line buffer, no spares
      */
     template <uint16_t N>
-    class cUARTRX : public nFRTOSExt::cObservedTask, public nText::cTexter<N> {
+    struct tLineSpare<N, 1> {
+        nText::cTextLine<N> *get(const uint8_t ucIndex) {
+            (void)ucIndex;
+            return NULL;
+        }
+    };
+/*! \endcond */
+
+
+    /**
+     * A class to read complete text lines that is FRTOS task friendly sourced from Arduino hardware UARTs built upon observer design pattern and queues
+     *
+     * \tparam N Text line length (characters, including NULL)
+     * \tparam F Framing engine class, see \ref nText::eFRAME.  Default "\r\n" terminated text lines.  Binary framing engines deliver frames
+     * that may contain NULL characters, observers use getLineLength
+     * \tparam D Line buffers, 1 to 8, default 1.  Receiving continues into a free buffer while observers own others, \ref acquire
+     */
+    template <uint16_t N, class F = nText::cFramerCRLF, uint8_t D = 1>
+    class cUARTRX : public nFRTOSExt::cObservedTask, public nText::cTexter<N, F> {
+        static_assert(D>=1 && D<=8, "cUARTRX line buffers D must be 1 to 8");
+
         public:
+            /**
+             * Enum of receive modes, how the receive task waits for characters
+             */
+            typedef enum {
+                eRXMODE_POLL        = 0,    ///< Poll UART with a fixed task delay between reads
+                eRXMODE_EVENT,              ///< Block on task notification given by \ref signal or \ref signalFromISR
+                eRXMODE_ADAPTIVE,           ///< Poll UART immediately while characters flow, back off exponentially when idle, \ref setAdaptive
+            }eRXMODE;
+
+
+            /**
+             * Receive statistics, \ref getStats
+             */
+            typedef struct {
+                uint32_t        ulWakeCount;        ///< Receive task wake ups after delay or notification wait
+                uint32_t        ulSignalCount;      ///< Signals given, \ref signal and \ref signalFromISR
+                TickType_t      xLatencyLast;       ///< Last line first character to notify latency (ticks)
+                TickType_t      xLatencyMax;        ///< Maximum line first character to notify latency (ticks)
+                TickType_t      xTicksBurst;        ///< \ref eRXMODE_ADAPTIVE time spent polling at minimum delay (ticks)
+                TickType_t      xTicksIdle;         ///< \ref eRXMODE_ADAPTIVE time spent backed off above minimum delay (ticks)
+                uint32_t        ulStarved;          ///< Times no line buffer was free after notify, all owned by observers
+                TickType_t      xTicksStarved;      ///< Time spent waiting for a free line buffer (ticks)
+                uint32_t        ulBytes;            ///< Bytes read from UART
+                uint32_t        ulLines;            ///< Lines notified
+                uint32_t        ulLatencySum;       ///< Sum of first character to notify latency for mean, /ulLines (ticks, wraps)
+                TickType_t      xTicksBlocked;      ///< Time spent delayed or waiting for a signal (ticks)
+            }tRXStats;
+
+
             /**
              * Constructor.  Make stable instance
              *
              * \param[in] xSerial Reference to Ardiuno hardware serial port instance, used to receive data
-             * \param[in] ucRXDelay FRTOS task delay in ticks between character reading (efficiency aid, default 5)
+             * \param[in] ucRXDelay FRTOS task delay in ticks between character reading (efficiency aid, default 5).  When eMode is
+             * \ref eRXMODE_EVENT it is the maximum ticks to wait for a signal before polling anyway, 0 waits forever.  When eMode is
+             * \ref eRXMODE_ADAPTIVE it is the maximum back off delay
+             * \param[in] eMode Receive mode, default \ref eRXMODE_POLL
              */
-            cUARTRX(HardwareSerial &xSerial, uint8_t ucRXDelay=5) : _xSerial(xSerial), _ucRXDelay(ucRXDelay) { }
+            cUARTRX(HardwareSerial &xSerial, uint8_t ucRXDelay=5, const eRXMODE eMode=eRXMODE_POLL) : _xSerial(xSerial), _ucRXDelay(ucRXDelay),
+                                                                    _eMode(eMode), _bFirstCharacter(false), _xFirstCharacter(0), _xLastRead(0),
+                                                                    _ucRXDelayMin(0), _ucBackOff(0), _bCharacterRead(false), _xRegimeTick(0),
+                                                                    _ucOwned(0), _ucDelivered(0), _ucFill(0) {
+                memset(&_xStats, 0, sizeof(_xStats));
+                memset(_ucLineFlags, 0, sizeof(_ucLineFlags));
+                memset(_ulLineMatches, 0, sizeof(_ulLineMatches));
+            }
 
 
             /**
@@ -46,6 +121,204 @@ namespace nFRTOSPeripheral {
             }
 
 
+            /**
+             * Set \ref eRXMODE_ADAPTIVE back off bounds.  Delay resets to ucMinDelay when characters are read and doubles on each idle
+             * poll up to ucMaxDelay
+             *
+             * \param[in] ucMinDelay Minimum delay (ticks), 0 only yields to other ready tasks of same priority
+             * \param[in] ucMaxDelay Maximum delay (ticks)
+             */
+            void setAdaptive(const uint8_t ucMinDelay, const uint8_t ucMaxDelay) {
+                _ucRXDelayMin=ucMinDelay;
+                _ucRXDelay=(ucMaxDelay<ucMinDelay) ? ucMinDelay : ucMaxDelay;
+                _ucBackOff=_ucRXDelayMin;
+            }
+
+
+            /**
+             * Signal receive task that characters have arrived, use with \ref eRXMODE_EVENT.  Task context only, e.g. serialEvent()
+             * or an idle hook
+             */
+            void signal() {
+                if (isValidHandle()) {
+                    taskENTER_CRITICAL();
+                    if (!_bFirstCharacter) {
+                        _xFirstCharacter=xTaskGetTickCount();
+                        _bFirstCharacter=true;
+                    }
+                    _xStats.ulSignalCount++;
+                    taskEXIT_CRITICAL();
+                    notifyGive();
+                }
+            }
+
+
+            /**
+             * Signal receive task that characters have arrived, use with \ref eRXMODE_EVENT.  ISR context only, e.g. from a UART RX
+             * interrupt hook or idle line callback
+             */
+            void signalFromISR() {
+                if (isValidHandle()) {
+                    UBaseType_t uxMask=taskENTER_CRITICAL_FROM_ISR();
+
+                    if (!_bFirstCharacter) {
+                        _xFirstCharacter=xTaskGetTickCountFromISR();
+                        _bFirstCharacter=true;
+                    }
+                    _xStats.ulSignalCount++;
+                    taskEXIT_CRITICAL_FROM_ISR(uxMask);
+                    notifyGiveFromISR();
+                }
+            }
+
+
+            /**
+             * Take ownership of line being notified so receiving continues into another buffer.  Invoke from observer update method
+             * only, then \ref release when handled (any task)
+             *
+             * \return Pointer to line, NULL when already owned
+             */
+            nText::cTextLine<N> *acquire() {
+                nText::cTextLine<N> *pxLine=NULL;
+
+                taskENTER_CRITICAL();
+                if (!(_ucOwned & (1U<<_ucDelivered))) {
+                    _ucOwned|=(1U<<_ucDelivered);
+                    pxLine=getLineBuffer(_ucDelivered);
+                }
+                taskEXIT_CRITICAL();
+
+                return pxLine;
+            }
+
+
+            /**
+             * Take ownership of line being notified with its flags and matches, which stay with the line while it is owned.
+             * \ref acquire
+             *
+             * \param[out] ucFlags \ref nText::eLINE flags of line
+             * \param[out] ulMatches Patterns matched in line, \ref nText::cTexter::setMatcher
+             * \return Pointer to line, NULL when already owned
+             */
+            nText::cTextLine<N> *acquire(uint8_t &ucFlags, uint32_t &ulMatches) {
+                ucFlags=_ucLineFlags[_ucDelivered];
+                ulMatches=_ulLineMatches[_ucDelivered];
+
+                return acquire();
+            }
+
+
+            /**
+             * Return ownership of line taken by \ref acquire, receive task may then reuse it
+             *
+             * \param[in] pxLine Pointer to line
+             */
+            void release(const nText::cTextLine<N> *pxLine) {
+                uint8_t ucI=lineIndex(pxLine);
+
+                if (ucI<D) {
+                    taskENTER_CRITICAL();
+                    _ucOwned&=~(1U<<ucI);
+                    taskEXIT_CRITICAL();
+
+                    notifyGive();       // wake receive task should it be starved
+                }
+            }
+
+
+            /**
+             * Get state flags of line being notified
+             *
+             * \return \ref nText::eLINE flags
+             */
+            uint8_t getLineFlags() const {
+                return _ucLineFlags[_ucDelivered];
+            }
+
+
+            /**
+             * Get state flags of owned line, \ref acquire
+             *
+             * \param[in] pxLine Pointer to line
+             * \return \ref nText::eLINE flags, eLINE_COMPLETE when not a line buffer
+             */
+            uint8_t getLineFlags(const nText::cTextLine<N> *pxLine) const {
+                uint8_t ucI=lineIndex(pxLine);
+
+                return (ucI<D) ? _ucLineFlags[ucI] : static_cast<uint8_t>(nText::eLINE_COMPLETE);
+            }
+
+
+            /**
+             * Get patterns matched in line being notified, \ref nText::cTexter::setMatcher
+             *
+             * \return Pattern mask, bit n set for pattern ID n
+             */
+            uint32_t getLineMatches() const {
+                return _ulLineMatches[_ucDelivered];
+            }
+
+
+            /**
+             * Get patterns matched in owned line, \ref acquire
+             *
+             * \param[in] pxLine Pointer to line
+             * \return Pattern mask, 0 when not a line buffer
+             */
+            uint32_t getLineMatches(const nText::cTextLine<N> *pxLine) const {
+                uint8_t ucI=lineIndex(pxLine);
+
+                return (ucI<D) ? _ulLineMatches[ucI] : 0;
+            }
+
+
+            /**
+             * Get pointer to null terminated string of line being notified
+             *
+             * \return Pointer to null terminated line string
+             */
+            const char *getLine() const {
+                return getLineBuffer(_ucDelivered)->getLine();
+            }
+
+
+            /**
+             * Get length of line being notified
+             *
+             * \return Characters (not including NULL terminator)
+             */
+            uint8_t getLineLength() const {
+                return getLineBuffer(_ucDelivered)->getLineLength();
+            }
+
+
+            /**
+             * Get receive statistics
+             *
+             * \return Copy of statistics
+             */
+            tRXStats getStats() const {
+                tRXStats xStats;
+
+                // receive task updates, copy whole so 32 bit counters do not tear
+                taskENTER_CRITICAL();
+                xStats=_xStats;
+                taskEXIT_CRITICAL();
+
+                return xStats;
+            }
+
+
+            /**
+             * Reset receive statistics
+             */
+            void resetStats() {
+                taskENTER_CRITICAL();
+                memset(&_xStats, 0, sizeof(_xStats));
+                taskEXIT_CRITICAL();
+            }
+
+
         protected:
             /**
              * Implemented to complete \ref nText::cTexter interface, not used in this here due to nature of simplex class (i.e. receive only)
@@ -58,13 +331,30 @@ namespace nFRTOSPeripheral {
 
 
             /**
-             * For \ref nText::cTexter interface, FRTOS inter-character delay.  Only bothered with this because interrupts are hidden from user for Arduino UART
+             * For \ref nText::cTexter interface, FRTOS inter-character delay.  Only bothered with this because interrupts are hidden from user for
+             * Arduino UART.  In \ref eRXMODE_EVENT mode wait for a signal instead
              */
-            void characterReadDelay() const {
-                // any character reading delay?  allows other tasks to do stuff.  since lower level serial has good character buffering its a good idea to use it
-                if (_ucRXDelay) {
-                    vTaskDelay(_ucRXDelay);
+            void characterReadDelay() {
+                TickType_t xBlocked=xTaskGetTickCount();
+                bool bWoken=false;
+
+                if (eRXMODE_EVENT==_eMode) {
+                    // block until signalled that characters have arrived, pending signals return immediately
+                    wait(_ucRXDelay ? static_cast<TickType_t>(_ucRXDelay) : portMAX_DELAY);
+                    bWoken=true;
+                }else if (eRXMODE_ADAPTIVE==_eMode) {
+                    adaptiveDelay();
+                }else if (_ucRXDelay) {
+                    // any character reading delay?  allows other tasks to do stuff.  since lower level serial has good character buffering its a good idea to use it
+                    delay(_ucRXDelay);
+                    bWoken=true;
                 }
+                xBlocked=xTaskGetTickCount()-xBlocked;
+
+                taskENTER_CRITICAL();
+                _xStats.ulWakeCount+=(bWoken ? 1 : 0);
+                _xStats.xTicksBlocked+=xBlocked;
+                taskEXIT_CRITICAL();
             }
 
 
@@ -80,6 +370,8 @@ namespace nFRTOSPeripheral {
                 if (_xSerial.available()) {
                     *pscChar=_xSerial.read();
                     bValid=true;
+                    charactersRead(1);
+                    _bCharacterRead=true;
                 }
 
                 return bValid;
@@ -87,119 +379,2034 @@ namespace nFRTOSPeripheral {
 
 
             /**
-             * Receive task loop.  Read a line and notify any listeners
+             * For \ref nText::cTexter interface.  Read all characters UART has buffered, up to usMax
+             *
+             * \param[out] pscBuffer Pointer to character receive buffer
+             * \param[in] usMax Maximum characters to read
+             * \return Characters read into pscBuffer
              */
-            void run() {
-                for (;;) {
-                    nText::cTexter<N>::blockingReadLine(this, nText::cTexter<N>::_scLine);
-                    notify();
+            uint16_t characterReadMany(char *pscBuffer, const uint16_t usMax) {
+                int iAvailable=_xSerial.available();
+                uint16_t usCount=0;
+
+                if (iAvailable>0) {
+                    if (iAvailable>usMax) {
+                        iAvailable=usMax;
+                    }
+                    while(usCount<iAvailable) {
+                        pscBuffer[usCount++]=_xSerial.read();
+                    }
+                    charactersRead(usCount);
+                    _bCharacterRead=true;
                 }
-            }
 
-        protected:
-            uint8_t                _ucRXDelay;
-            HardwareSerial&        _xSerial;
-    }; // class cUARTRX
+                return usCount;
+            }
 
 
-    /**
-     * A wrapper class for an Arduino hardware UART TX operation that is FRTOS task friendly using queues
-     *
-     * \tparam N Text line length (characters, including NULL)
-     */
-    template <uint16_t N>
-    class cUARTTX : public nFRTOS::cTask {
-        public:
             /**
-             * Constructor.  Make stable instance
+             * Receive task delay, yields when 0
              *
-             * \param[in] xSerial Reference to Ardiuno hardware serial port instance, used to receive data
-             * \param ucQueueSize in cTextLine objects
+             * \param[in] xTicks Delay (ticks)
              */
-            cUARTTX(HardwareSerial &xSerial, const uint8_t ucQueueSize) : _xSerial(xSerial), _xTxQueue(ucQueueSize) {
+            virtual void delay(const TickType_t xTicks) {
+                if (xTicks) {
+                    vTaskDelay(xTicks);
+                }else {
+                    taskYIELD();
+                }
             }
 
 
             /**
-             * Transmit given cTextLine over UART, FRTOS task safe, posts on TX queue
+             * Receive task wait for notification, \ref signal or \ref release
              *
-             * \param[in] xTextLine Reference to instance of text line to send.  Should include line ending like "\r\n"
-             * \return Transmit success or failure
+             * \param[in] xTicks Maximum wait (ticks)
              */
-            bool transmit(nText::cTextLine<N> &xTextLine) {
-                return _xTxQueue.send(xTextLine);
+            virtual void wait(const TickType_t xTicks) {
+                notifyTake(xTicks);
             }
 
 
             /**
-             * Transmit given character string over UART, FRTOS task safe, posts on TX queue
+             * \ref eRXMODE_ADAPTIVE delay.  Characters read since last delay return to minimum delay otherwise double it up to maximum,
+             * time is accounted to burst or idle regime of the previous delay
+             */
+            void adaptiveDelay() {
+                TickType_t xNow=xTaskGetTickCount();
+
+                taskENTER_CRITICAL();
+                if (_ucBackOff>_ucRXDelayMin) {
+                    _xStats.xTicksIdle+=xNow-_xRegimeTick;
+                }else {
+                    _xStats.xTicksBurst+=xNow-_xRegimeTick;
+                }
+                taskEXIT_CRITICAL();
+                _xRegimeTick=xNow;
+
+                if (_bCharacterRead) {
+                    _bCharacterRead=false;
+                    _ucBackOff=_ucRXDelayMin;
+                }else if (_ucBackOff<_ucRXDelay) {
+                    _ucBackOff=(_ucBackOff>(_ucRXDelay>>1)) ? _ucRXDelay : ((_ucBackOff<<1) | 1);
+                    if (_ucBackOff<_ucRXDelayMin) {
+                        _ucBackOff=_ucRXDelayMin;
+                    }
+                }
+
+                delay(_ucBackOff);
+                taskENTER_CRITICAL();
+                _xStats.ulWakeCount++;
+                taskEXIT_CRITICAL();
+            }
+
+
+            /**
+             * Account characters read, timestamp first character of line when not signalled (polling)
              *
-             *    \param[in] pscTextLine Null terminated character string pointer.  Should include line ending "\r\n"
-             *    \return Transmit success or failure
+             * \param[in] usCount Characters read
              */
-            bool transmit(const char *pscTextLine) {
-                nText::cTextLine<N> xTextLine(pscTextLine);
-    
-                return _xTxQueue.send(xTextLine);
+            void charactersRead(const uint16_t usCount) {
+                taskENTER_CRITICAL();
+                _xStats.ulBytes+=usCount;
+                _xLastRead=xTaskGetTickCount();
+                if (!_bFirstCharacter) {
+                    _xFirstCharacter=_xLastRead;
+                    _bFirstCharacter=true;
+                }
+                taskEXIT_CRITICAL();
             }
 
 
             /**
-             * Transmit given fixed length character string over UART, FRTOS task safe, posts on TX queue
+             * Receive task loop.  Read a line and notify any listeners
+             */
+            void run() {
+                _xRegimeTick=xTaskGetTickCount();    // first regime starts now, not at boot
+                for (;;) {
+                    nText::cTexter<N, F>::blockingReadLine(this, *getLineBuffer(_ucFill));
+                    lineComplete();
+                }
+            }
+
+
+            /**
+             * Line read into fill buffer, notify any listeners and move on to a free buffer
+             */
+            void lineComplete() {
+                // flags and matches belong to the buffer, next line may be read before an owner looks
+                _ucLineFlags[_ucFill]=nText::cTexter<N, F>::getLineFlags();
+                _ulLineMatches[_ucFill]=nText::cTexter<N, F>::getLineMatches();
+                _ucDelivered=_ucFill;
+                notify();
+                _ucFill=nextLineBuffer();
+
+                taskENTER_CRITICAL();
+                _xStats.ulLines++;
+                _xStats.xLatencyLast=xTaskGetTickCount()-_xFirstCharacter;
+                _xStats.ulLatencySum+=_xStats.xLatencyLast;
+                if (_xStats.xLatencyLast>_xStats.xLatencyMax) {
+                    _xStats.xLatencyMax=_xStats.xLatencyLast;
+                }
+                // next line already staged?  its first character arrived no later than the read that staged it
+                _bFirstCharacter=nText::cTexter<N, F>::isStaged();
+                if (_bFirstCharacter) {
+                    _xFirstCharacter=_xLastRead;
+                }
+                taskEXIT_CRITICAL();
+            }
+
+
+            /**
+             * Get line buffer by index
              *
-             * \param[in] pscTextLine Null terminated character string pointer.  Should include line ending "\r\n"
-             * \param ucLength Length of string in characters, should not include NULL terminator
-             * \return Transmit success or failure
+             * \param[in] ucIndex Buffer index, 0 is this instance
+             * \return Pointer to line
              */
-            bool transmit(const char *pscTextLine, const uint8_t ucLength) {
-                nText::cTextLine<N> xTextLine(pscTextLine, ucLength);
+            nText::cTextLine<N> *getLineBuffer(const uint8_t ucIndex) {
+                return ucIndex ? _xSpare.get(ucIndex) : static_cast<nText::cTextLine<N>*>(this);
+            }
 
-                return _xTxQueue.send(xTextLine);
+
+            /**
+             * Get line buffer by index
+             *
+             * \param[in] ucIndex Buffer index, 0 is this instance
+             * \return Pointer to line
+             */
+            const nText::cTextLine<N> *getLineBuffer(const uint8_t ucIndex) const {
+                return const_cast<cUARTRX<N, F, D>*>(this)->getLineBuffer(ucIndex);
             }
 
 
             /**
-             * Create task and start it + create queue
+             * Get line buffer index
              *
-             * \note Originally setup task name as "UArtT<tx pin>" but no debugger for arduino code so no point
-             * \return Join and queue state
+             * \param[in] pxLine Pointer to line
+             * \return Buffer index, D when not a line buffer
              */
-            bool join(const UBaseType_t priority = tskIDLE_PRIORITY + 1, const uint32_t stackSize=configMINIMAL_STACK_SIZE * 4) {
-                if (!isValidHandle()) {
-                    start(NULL, priority, stackSize);
+            uint8_t lineIndex(const nText::cTextLine<N> *pxLine) const {
+                uint8_t ucI;
 
-                    _xTxQueue.create();
-                }
+                for(ucI=0;ucI<D && pxLine!=getLineBuffer(ucI);ucI++);
 
-                return isValidHandle() && _xTxQueue.isValidHandle();
+                return ucI;
             }
 
-        protected:
 
             /**
-             * Transmit task loop.  Read TX queue and output line over hardware UART
+             * Find a line buffer not owned by observers, waits when all are owned
+             *
+             * \return Buffer index
              */
-            void run() {
-                nText::cTextLine<N> data;
+            uint8_t nextLineBuffer() {
+                TickType_t xStarved=0;
+                uint8_t ucI;
 
-                for (;;) {
-                    // Wait for tx data (endlessly), is it ok?
-                    if (_xTxQueue.receive(data)) {
-                        uint8_t l=data.getLineLength();
-                        const char *pscLine=data.getLine();
-
-                        // Send over serial
-                        for(uint8_t i=0;i<l;i++) {
-                            _xSerial.write(pscLine[i]);
-                        }
+                for(;;) {
+                    taskENTER_CRITICAL();
+                    for(ucI=0;ucI<D && (_ucOwned & (1U<<ucI));ucI++);
+                    taskEXIT_CRITICAL();
+
+                    if (ucI<D) {
+                        break;
                     }
+
+                    if (!xStarved) {
+                        xStarved=xTaskGetTickCount();
+                        taskENTER_CRITICAL();
+                        _xStats.ulStarved++;
+                        taskEXIT_CRITICAL();
+                    }
+                    wait(portMAX_DELAY);    // woken by release, signals share notifications so check again
+                }
+
+                if (xStarved) {
+                    xStarved=xTaskGetTickCount()-xStarved;
+                    taskENTER_CRITICAL();
+                    _xStats.xTicksStarved+=xStarved;
+                    taskEXIT_CRITICAL();
                 }
+
+                return ucI;
             }
 
         protected:
-            nFRTOS::cQueue<nText::cTextLine<N>>    _xTxQueue;
-            HardwareSerial&                        _xSerial;
-    }; // class cUARTTX
+            uint8_t                _ucRXDelay;
+            HardwareSerial&        _xSerial;
+            eRXMODE                _eMode;
+            volatile bool          _bFirstCharacter;        ///< First character of line timestamped state
+            volatile TickType_t    _xFirstCharacter;        ///< First character of line timestamp (ticks)
+            TickType_t             _xLastRead;              ///< Last characters read timestamp (ticks)
+            tRXStats               _xStats;
+            uint8_t                _ucRXDelayMin;           ///< \ref eRXMODE_ADAPTIVE minimum delay (ticks)
+            uint8_t                _ucBackOff;              ///< \ref eRXMODE_ADAPTIVE current delay (ticks)
+            bool                   _bCharacterRead;         ///< Characters read since last delay state
+            TickType_t             _xRegimeTick;            ///< \ref eRXMODE_ADAPTIVE last delay timestamp (ticks)
+            volatile uint8_t       _ucOwned;                ///< Line buffers owned by observers (bit mask)
+            uint8_t                _ucDelivered;            ///< Line buffer being notified
+            uint8_t                _ucFill;                 ///< Line buffer being read into
+            uint8_t                _ucLineFlags[D];         ///< Line \ref nText::eLINE flags per buffer
+            uint32_t               _ulLineMatches[D];       ///< Line patterns matched per buffer
+            tLineSpare<N, D>       _xSpare;                 ///< Line buffers beyond this instance
+    }; // class cUARTRX
+
+
+    /**
+     * Bytes copied from flash per UART write by \ref cUARTTXEngine when streaming flash strings, held on TX task stack.  Define your
+     * own should you wish to change
+     */
+#if !defined(CUARTTX_FLASH_CHUNK)
+    #define CUARTTX_FLASH_CHUNK     16
+#endif
+
+
+    /**
+     * Bytes compressed per UART write by \ref cUARTTXEngine when a compressor is set, output buffer held on TX task stack.  Define
+     * your own should you wish to change
+     */
+#if !defined(CUARTTX_COMPRESS_CHUNK)
+    #define CUARTTX_COMPRESS_CHUNK  32
+#endif
+
+
+    /**
+     * TX queue items serviced by \ref cUART per wake before it returns to receiving, bounds transmit time so the UART receive
+     * buffer does not overrun under sustained transmit load.  Define your own should you wish to change
+     */
+#if !defined(CUART_TX_BUDGET)
+    #define CUART_TX_BUDGET         4
+#endif
+
+
+    /**
+     * No half duplex driver enable pin, \ref cUARTTXEngine::setHalfDuplex
+     */
+#define CUARTTX_NO_PIN              0xff
+
+
+    /**
+     * A class implementing Arduino hardware UART TX operation using a queue, FRTOS task safe.  Serviced by a task, see \ref cUARTTX and \ref cUART
+     *
+     * \tparam N Text line length (characters, including NULL)
+     */
+    template <uint16_t N>
+    class cUARTTXEngine {
+        public:
+            /**
+             * Longest line transmitted whole (characters), longer lines are truncated
+             */
+            enum {
+                eTX_LINE_MAX    = N-1
+            };
+
+
+            /**
+             * Transmit backpressure policy, action when TX queue is full.  \ref setBackpressure
+             */
+            typedef enum {
+                eTXPOLICY_BLOCK=0,              ///< Wait for space, unlimited (default)
+                eTXPOLICY_FAIL,                 ///< Fail immediately
+                eTXPOLICY_TIMEOUT,              ///< Wait for space up to timeout then fail
+                eTXPOLICY_DROP_OLDEST,          ///< Discard oldest queued line to make space.  Fails when oldest has a completion, notification or is a flush marker
+                eTXPOLICY_DROP_NEWEST,          ///< Discard line being transmitted, reports success.  Fails when line has a completion or notification
+                eTXPOLICY_INSTANCE              ///< Per call only, use instance policy
+            }eTXPOLICY;
+
+
+            /**
+             * Scatter-gather segment, \ref transmitSegments
+             */
+            typedef struct {
+                const uint8_t   *pucData;           ///< Pointer to data
+                uint16_t        usLength;           ///< Data length (bytes)
+            }tTXSegment;
+
+
+            /**
+             * Transmit completion callback, invoked by TX task once all segments are written
+             *
+             * \param[in] pvContext User context given to \ref transmitSegments
+             */
+            typedef void (*tTXComplete)(void *pvContext);
+
+
+            /**
+             * Transmit statistics, \ref getStats
+             */
+            typedef struct {
+                uint32_t        ulBytes;            ///< Bytes written to UART
+                uint32_t        ulLines;            ///< Lines written
+                uint32_t        ulDropped;          ///< Lines not transmitted, all policies
+                uint32_t        ulFailed;           ///< Lines not queued, \ref eTXPOLICY_FAIL or drop policy with nothing droppable
+                uint32_t        ulTimedOut;         ///< Lines not queued, \ref eTXPOLICY_TIMEOUT
+                uint32_t        ulDroppedOldest;    ///< Queued lines discarded, \ref eTXPOLICY_DROP_OLDEST
+                uint32_t        ulDroppedNewest;    ///< Lines discarded, \ref eTXPOLICY_DROP_NEWEST
+                TickType_t      xLatencyMax;        ///< Maximum transmit call to last byte written latency (ticks)
+                uint32_t        ulLatencySum;       ///< Sum of latency for mean, /ulLines (ticks, wraps)
+                TickType_t      xTicksBlocked;      ///< Time spent writing to UART, blocked when its buffer is full (ticks)
+                uint32_t        ulBursts;           ///< UART writes of one or more lines, lines per burst is ulLines/ulBursts
+                uint16_t        usBurstLinesMax;    ///< Maximum lines in a burst
+                uint32_t        ulTurnarounds;      ///< Half duplex driver releases
+                uint32_t        ulTurnaroundLast;   ///< Last transmit complete to driver released time (microseconds)
+                uint32_t        ulTurnaroundMax;    ///< Maximum transmit complete to driver released time (microseconds)
+                uint32_t        ulDrainMax;         ///< Maximum wait for transmit complete before release (microseconds)
+            }tTXStats;
+
+
+            /**
+             * Constructor.  Make stable instance
+             *
+             * \param[in] xSerial Reference to Ardiuno hardware serial port instance, used to transmit data
+             * \param ucQueueSize in cTextLine objects
+             */
+            cUARTTXEngine(HardwareSerial &xSerial, const uint8_t ucQueueSize) : _xTxSerial(xSerial), _xTxQueue(ucQueueSize),
+                                                    _pucStage(NULL), _usStageSize(0), _xHold(0), _usStaged(0), _usBurstLines(0),
+                                                    _ulBurstQueued(0), _xBurstOldest(0), _ePolicy(eTXPOLICY_BLOCK), _xPolicyTimeout(0),
+                                                    _pxCompress(NULL), _ucDEPin(CUARTTX_NO_PIN), _bDEActiveHigh(true), _bDE(false),
+                                                    _xFlushDone(NULL), _xFlushLock(NULL), _usFlushSequence(0), _usFlushed(0) {
+                memset(&_xTxStats, 0, sizeof(_xTxStats));
+            }
+
+
+            /**
+             * Set coalescing, after waking the TX task gathers queued lines into a staging buffer and writes them in one burst.  Fewer
+             * wake ups and writes when many small lines are sent.  Set before join
+             *
+             * \param[in] pucStage Pointer to staging buffer, NULL disables coalescing
+             * \param[in] usStageSize Staging buffer size, burst byte budget (bytes)
+             * \param[in] xHold Maximum time to hold the first line of a burst waiting for more (ticks), 0 takes only those queued
+             */
+            void setCoalescing(uint8_t *pucStage, const uint16_t usStageSize, const TickType_t xHold=0) {
+                _pucStage=pucStage;
+                _usStageSize=pucStage ? usStageSize : 0;
+                _xHold=xHold;
+            }
+
+
+            /**
+             * Set compressor, everything written to UART passes through it.  Blocks are ended when the TX queue goes idle, on
+             * \ref flush and before completions so the host decoder, e.g. tools/lzss_decode.py, has all data sent.  Set before join,
+             * compression ratio and CPU cost are in the compressor statistics
+             *
+             * \param[in] pxCompress Pointer to compressor, e.g. \ref nText::cCompressLZSS, or NULL to disable
+             */
+            void setCompressor(nText::cCompress *pxCompress) {
+                _pxCompress=pxCompress;
+            }
+
+
+            /**
+             * Set half duplex mode, e.g. RS-485.  Driver enable (DE, often tied to /RE) is asserted before the first byte of a burst
+             * and released as soon as the UART reports transmit complete (last stop bit sent) once the TX queue is idle, no fixed
+             * delays.  Set before join
+             *
+             * \note Transmit complete is detected by HardwareSerial::flush(), which on most cores busy waits for it
+             * \param[in] ucPin Driver enable pin or CUARTTX_NO_PIN to disable
+             * \param[in] bActiveHigh Driver enabled level
+             */
+            void setHalfDuplex(const uint8_t ucPin, const bool bActiveHigh=true) {
+                _ucDEPin=ucPin;
+                _bDEActiveHigh=bActiveHigh;
+                _bDE=false;
+                if (CUARTTX_NO_PIN!=ucPin) {
+                    pinMode(ucPin, OUTPUT);
+                    driverEnable(false);
+                }
+            }
+
+
+            /**
+             * Set backpressure policy used by transmit when TX queue is full.  Tasks that must never stall, like control loops that
+             * log, should not use \ref eTXPOLICY_BLOCK
+             *
+             * \param[in] ePolicy Policy, not \ref eTXPOLICY_INSTANCE
+             * \param[in] xTimeout \ref eTXPOLICY_TIMEOUT wait (ticks)
+             */
+            void setBackpressure(const eTXPOLICY ePolicy, const TickType_t xTimeout=0) {
+                if (eTXPOLICY_INSTANCE!=ePolicy) {
+                    _ePolicy=ePolicy;
+                    _xPolicyTimeout=xTimeout;
+                }
+            }
+
+
+            /**
+             * Get backpressure policy used by transmit, \ref setBackpressure
+             *
+             * \return Policy
+             */
+            eTXPOLICY getBackpressure() const {
+                return _ePolicy;
+            }
+
+
+            /**
+             * Transmit given cTextLine over UART, FRTOS task safe, posts on TX queue
+             *
+             * \param[in] xTextLine Reference to instance of text line to send.  Should include line ending like "\r\n"
+             * \param[in] ePolicy Backpressure policy, default instance policy \ref setBackpressure
+             * \param[in] xTimeout \ref eTXPOLICY_TIMEOUT wait (ticks)
+             * \return Transmit success or failure
+             */
+            bool transmit(nText::cTextLine<N> &xTextLine, const eTXPOLICY ePolicy=eTXPOLICY_INSTANCE, const TickType_t xTimeout=0) {
+                tTXItem xItem;
+
+                xItem.ucType=eTXITEM_LINE;
+
+                xItem.xNotify=NULL;
+                xItem.xLine=xTextLine;
+
+                return post(xItem, ePolicy, xTimeout);
+            }
+
+
+            /**
+             * Transmit given character string over UART, FRTOS task safe, posts on TX queue
+             *
+             *    \param[in] pscTextLine Null terminated character string pointer.  Should include line ending "\r\n"
+             *    \param[in] ePolicy Backpressure policy, default instance policy \ref setBackpressure
+             *    \param[in] xTimeout \ref eTXPOLICY_TIMEOUT wait (ticks)
+             *    \return Transmit success or failure
+             */
+            bool transmit(const char *pscTextLine, const eTXPOLICY ePolicy=eTXPOLICY_INSTANCE, const TickType_t xTimeout=0) {
+                tTXItem xItem;
+
+                xItem.ucType=eTXITEM_LINE;
+
+                xItem.xNotify=NULL;
+                xItem.xLine.setLine(pscTextLine, strlen(pscTextLine));
+
+                return post(xItem, ePolicy, xTimeout);
+            }
+
+
+            /**
+             * Transmit given fixed length character string over UART, FRTOS task safe, posts on TX queue
+             *
+             * \param[in] pscTextLine Null terminated character string pointer.  Should include line ending "\r\n"
+             * \param ucLength Length of string in characters, should not include NULL terminator
+             * \param[in] ePolicy Backpressure policy, default instance policy \ref setBackpressure
+             * \param[in] xTimeout \ref eTXPOLICY_TIMEOUT wait (ticks)
+             * \return Transmit success or failure
+             */
+            bool transmit(const char *pscTextLine, const uint8_t ucLength, const eTXPOLICY ePolicy=eTXPOLICY_INSTANCE,
+                                                                                                const TickType_t xTimeout=0) {
+                tTXItem xItem;
+
+                xItem.ucType=eTXITEM_LINE;
+
+                xItem.xNotify=NULL;
+                xItem.xLine.setLine(pscTextLine, ucLength);
+
+                return post(xItem, ePolicy, xTimeout);
+            }
+
+
+            /**
+             * Transmit given flash character string over UART, FRTOS task safe, posts pointer on TX queue.  TX task streams it from
+             * flash so the string takes no SRAM, e.g. transmit(F("Hello\r\n"))
+             *
+             * \param[in] pxTextLine Pointer to flash (PROGMEM) null terminated character string, must remain valid
+             * \param[in] ePolicy Backpressure policy, default instance policy \ref setBackpressure
+             * \param[in] xTimeout \ref eTXPOLICY_TIMEOUT wait (ticks)
+             * \return Transmit success or failure
+             */
+            bool transmit(const __FlashStringHelper *pxTextLine, const eTXPOLICY ePolicy=eTXPOLICY_INSTANCE, const TickType_t xTimeout=0) {
+                tTXItem xItem;
+
+                xItem.ucType=eTXITEM_FLASH;
+
+                xItem.xNotify=NULL;
+                xItem.xRef.pscRef=reinterpret_cast<const char*>(pxTextLine);
+                xItem.xRef.usRefLength=static_cast<uint16_t>(strlen_P(xItem.xRef.pscRef));
+
+                return post(xItem, ePolicy, xTimeout);
+            }
+
+
+            /**
+             * Transmit given immutable character string over UART, FRTOS task safe, posts pointer on TX queue, no copy.  Length is
+             * not limited by line length N
+             *
+             * \param[in] pscText Pointer to character string, must remain valid and unchanged until written
+             * \param[in] usLength Length of string in characters
+             * \param[in] ePolicy Backpressure policy, default instance policy \ref setBackpressure
+             * \param[in] xTimeout \ref eTXPOLICY_TIMEOUT wait (ticks)
+             * \return Transmit success or failure
+             */
+            bool transmitStatic(const char *pscText, const uint16_t usLength, const eTXPOLICY ePolicy=eTXPOLICY_INSTANCE,
+                                                                                                const TickType_t xTimeout=0) {
+                tTXItem xItem;
+
+                xItem.ucType=eTXITEM_STATIC;
+
+                xItem.xNotify=NULL;
+                xItem.xRef.pscRef=pscText;
+                xItem.xRef.usRefLength=usLength;
+
+                return post(xItem, ePolicy, xTimeout);
+            }
+
+
+            /**
+             * Transmit given immutable null terminated character string over UART, \ref transmitStatic
+             *
+             * \param[in] pscText Pointer to null terminated character string, must remain valid and unchanged until written
+             * \param[in] ePolicy Backpressure policy, default instance policy \ref setBackpressure
+             * \param[in] xTimeout \ref eTXPOLICY_TIMEOUT wait (ticks)
+             * \return Transmit success or failure
+             */
+            bool transmitStatic(const char *pscText, const eTXPOLICY ePolicy=eTXPOLICY_INSTANCE, const TickType_t xTimeout=0) {
+                return transmitStatic(pscText, static_cast<uint16_t>(strlen(pscText)), ePolicy, xTimeout);
+            }
+
+
+            /**
+             * Transmit given cTextLine over UART, FRTOS task safe, posts on TX queue.  Task is given a notification once the line is
+             * written to the UART driver, wait with ulTaskNotifyTake
+             *
+             * \param[in] xTextLine Reference to instance of text line to send
+             * \param[in] xNotify Task to notify, usually xTaskGetCurrentTaskHandle()
+             * \param[in] ePolicy Backpressure policy, default instance policy \ref setBackpressure
+             * \param[in] xTimeout \ref eTXPOLICY_TIMEOUT wait (ticks)
+             * \return Transmit success or failure, no notification on failure
+             */
+            bool transmit(nText::cTextLine<N> &xTextLine, const TaskHandle_t xNotify, const eTXPOLICY ePolicy=eTXPOLICY_INSTANCE,
+                                                                                                const TickType_t xTimeout=0) {
+                tTXItem xItem;
+
+                xItem.ucType=eTXITEM_LINE;
+                xItem.xNotify=xNotify;
+                xItem.xLine=xTextLine;
+
+                return post(xItem, ePolicy, xTimeout);
+            }
+
+
+            /**
+             * Transmit given immutable character string over UART, \ref transmitStatic.  Task is given a notification once the string
+             * is written to the UART driver, after which it may be changed
+             *
+             * \param[in] pscText Pointer to character string, must remain valid and unchanged until notified
+             * \param[in] usLength Length of string in characters
+             * \param[in] xNotify Task to notify, usually xTaskGetCurrentTaskHandle()
+             * \param[in] ePolicy Backpressure policy, default instance policy \ref setBackpressure
+             * \param[in] xTimeout \ref eTXPOLICY_TIMEOUT wait (ticks)
+             * \return Transmit success or failure, no notification on failure
+             */
+            bool transmitStatic(const char *pscText, const uint16_t usLength, const TaskHandle_t xNotify,
+                                        const eTXPOLICY ePolicy=eTXPOLICY_INSTANCE, const TickType_t xTimeout=0) {
+                tTXItem xItem;
+
+                xItem.ucType=eTXITEM_STATIC;
+                xItem.xNotify=xNotify;
+                xItem.xRef.pscRef=pscText;
+                xItem.xRef.usRefLength=usLength;
+
+                return post(xItem, ePolicy, xTimeout);
+            }
+
+
+            /**
+             * Transmit segments in order over UART, FRTOS task safe, posts segment list on TX queue, no copy.  For example a protocol
+             * header, payload from a sensor buffer and a CRC trailer without concatenating them.  Segment list and the data it points
+             * to belong to the TX task from a successful call until pfComplete is invoked (or xNotify notified), then return to the
+             * caller.  On failure nothing is queued and no completion is given
+             *
+             * \param[in] pxSegments Pointer to segment list, must remain valid until completion
+             * \param[in] ucCount Segment count
+             * \param[in] pfComplete Completion callback or NULL, runs on TX task so keep short
+             * \param[in] pvContext Callback context
+             * \param[in] xNotify Task to notify on completion or NULL
+             * \param[in] ePolicy Backpressure policy, default instance policy \ref setBackpressure
+             * \param[in] xTimeout \ref eTXPOLICY_TIMEOUT wait (ticks)
+             * \return Transmit success or failure
+             */
+            bool transmitSegments(const tTXSegment *pxSegments, const uint8_t ucCount, const tTXComplete pfComplete=NULL,
+                                        void *pvContext=NULL, const TaskHandle_t xNotify=NULL, const eTXPOLICY ePolicy=eTXPOLICY_INSTANCE,
+                                                                                                        const TickType_t xTimeout=0) {
+                tTXItem xItem;
+
+                xItem.ucType=eTXITEM_SEGMENTS;
+                xItem.xNotify=xNotify;
+                xItem.xRef.pfComplete=pfComplete;
+                xItem.xRef.pvContext=pvContext;
+                xItem.xRef.pxSegments=pxSegments;
+                xItem.xRef.usRefLength=ucCount;
+
+                return post(xItem, ePolicy, xTimeout);
+            }
+
+
+            /**
+             * Wait until everything queued before this call has left the UART, TX queue drained and HardwareSerial TX buffer empty.
+             * Use before sleeping or changing baud rate.  Flushing tasks are serialised and wait on an engine semaphore, not their task
+             * notification.  A marker left queued by a timed out flush completes later without satisfying another flush
+             *
+             * \note From the task servicing the TX queue, e.g. a \ref cUART observer, items are serviced in the call
+             * \param[in] xTimeout Ticks to wait.  Default portMAX_DELAY (unlimited)
+             * \return Flushed state, false on timeout
+             */
+            bool flush(const TickType_t xTimeout=portMAX_DELAY) {
+                tTXItem xItem;
+                bool bFlushed=false;
+
+                xItem.xQueued=xTaskGetTickCount();
+                if (pdTRUE!=xSemaphoreTake(_xFlushLock, xTimeout)) {
+                    return false;
+                }
+
+                // marker is never dropped by backpressure policy, see itemDroppable
+                xItem.ucType=eTXITEM_FLUSH;
+                xItem.xNotify=NULL;
+                xItem.xRef.usRefLength=++_usFlushSequence;
+                if (sendWait(xItem, timeRemaining(xItem.xQueued, xTimeout))) {
+                    posted();
+
+                    // servicing task writes the marker itself
+                    while (servicing() && xItem.xRef.usRefLength!=_usFlushed && serviceBudget(1)) {
+                    }
+
+                    // semaphore is also given by markers of earlier timed out flushes
+                    while (!bFlushed && pdTRUE==xSemaphoreTake(_xFlushDone, timeRemaining(xItem.xQueued, xTimeout))) {
+                        bFlushed=(xItem.xRef.usRefLength==_usFlushed);
+                    }
+                }
+                xSemaphoreGive(_xFlushLock);
+
+                return bFlushed;
+            }
+
+
+            /**
+             * Get transmit statistics
+             *
+             * \return Copy of statistics
+             */
+            tTXStats getStats() const {
+                tTXStats xStats;
+
+                // producers and TX task update, copy whole so 32 bit counters do not tear
+                taskENTER_CRITICAL();
+                xStats=_xTxStats;
+                taskEXIT_CRITICAL();
+
+                return xStats;
+            }
+
+
+            /**
+             * Reset transmit statistics
+             */
+            void resetStats() {
+                taskENTER_CRITICAL();
+                memset(&_xTxStats, 0, sizeof(_xTxStats));
+                taskEXIT_CRITICAL();
+            }
+
+        protected:
+            /**
+             * TX queue element types
+             */
+            typedef enum {
+                eTXITEM_LINE=0,                 ///< Line copy in item
+                eTXITEM_FLASH,                  ///< Flash string reference
+                eTXITEM_STATIC,                 ///< Immutable string reference
+                eTXITEM_FLUSH,                  ///< Flush marker, \ref flush
+                eTXITEM_SEGMENTS                ///< Segment list reference, \ref transmitSegments
+            }eTXITEM;
+
+
+            /**
+             * TX queue element reference content, \ref eTXITEM_FLASH, \ref eTXITEM_STATIC and \ref eTXITEM_SEGMENTS
+             */
+            typedef struct {
+                union {
+                    const char*         pscRef;         ///< String to write, \ref eTXITEM_FLASH or \ref eTXITEM_STATIC
+                    const tTXSegment*   pxSegments;     ///< Segments to write, \ref eTXITEM_SEGMENTS
+                };
+                uint16_t                usRefLength;    ///< String length (characters), segment count or flush sequence
+                tTXComplete             pfComplete;     ///< Callback once written or NULL, \ref eTXITEM_SEGMENTS
+                void*                   pvContext;      ///< Callback context, \ref eTXITEM_SEGMENTS
+            }tTXRef;
+
+
+            /**
+             * TX queue element, line copy and reference share storage so a slot costs the larger of them
+             */
+            struct tTXItem {
+                union {
+                    nText::cTextLine<N> xLine;          ///< Line to write, \ref eTXITEM_LINE
+                    tTXRef              xRef;           ///< Reference to write, other types
+                };
+                TickType_t              xQueued;        ///< Transmit call timestamp (ticks)
+                uint8_t                 ucType;         ///< Item type, \ref eTXITEM
+                TaskHandle_t            xNotify;        ///< Task notified once written or NULL
+
+                tTXItem() { }       // content set by type
+            };
+
+
+            /**
+             * Get ticks remaining of a timeout
+             *
+             * \param[in] xStart Start of wait (ticks)
+             * \param[in] xTimeout Ticks to wait, portMAX_DELAY (unlimited)
+             * \return Ticks remaining
+             */
+            static TickType_t timeRemaining(const TickType_t xStart, const TickType_t xTimeout) {
+                TickType_t xElapsed;
+
+                if (portMAX_DELAY==xTimeout) {
+                    return xTimeout;
+                }
+                xElapsed=xTaskGetTickCount()-xStart;
+
+                return (xElapsed<xTimeout) ? xTimeout-xElapsed : 0;
+            }
+
+
+            /**
+             * Create TX queue and \ref flush semaphores, called by join
+             *
+             * \return Created state
+             */
+            bool createQueue() {
+                _xTxQueue.create();
+                _xFlushDone=xSemaphoreCreateBinary();
+                _xFlushLock=xSemaphoreCreateMutex();
+
+                return isQueueValid();
+            }
+
+
+            /**
+             * Get TX queue and \ref flush semaphores created
+             *
+             * \return Valid state
+             */
+            bool isQueueValid() const {
+                return _xTxQueue.isValidHandle() && NULL!=_xFlushDone && NULL!=_xFlushLock;
+            }
+
+
+            /**
+             * Get item completion callback
+             *
+             * \param[in] xItem Reference to item
+             * \return Callback or NULL
+             */
+            static tTXComplete itemComplete(const tTXItem &xItem) {
+                return (eTXITEM_SEGMENTS==xItem.ucType) ? xItem.xRef.pfComplete : NULL;
+            }
+
+
+            /**
+             * Get item discardable by drop policy, no completion, notification or flush waiter to satisfy
+             *
+             * \param[in] xItem Reference to item
+             * \return Droppable state
+             */
+            static bool itemDroppable(const tTXItem &xItem) {
+                return (eTXITEM_FLUSH!=xItem.ucType && NULL==xItem.xNotify && NULL==itemComplete(xItem));
+            }
+
+
+            /**
+             * Post item on TX queue, timestamped.  When full apply backpressure policy
+             *
+             * \param[in,out] xItem Reference to item
+             * \param[in] ePolicy Backpressure policy, \ref eTXPOLICY_INSTANCE for instance policy
+             * \param[in] xTimeout \ref eTXPOLICY_TIMEOUT wait (ticks)
+             * \return Transmit success or failure
+             */
+            bool post(tTXItem &xItem, eTXPOLICY ePolicy=eTXPOLICY_INSTANCE, TickType_t xTimeout=0) {
+                tTXItem xOldest;
+                uint32_t *pulFailed=NULL, *pulDropped=NULL;
+                bool bSent, bQueued=true;
+
+                if (eTXPOLICY_INSTANCE==ePolicy) {
+                    ePolicy=_ePolicy;
+                    xTimeout=_xPolicyTimeout;
+                }
+
+                xItem.xQueued=xTaskGetTickCount();
+                switch(ePolicy) {
+                    case eTXPOLICY_TIMEOUT :
+                        bSent=sendWait(xItem, xTimeout);
+                        pulFailed=&_xTxStats.ulTimedOut;
+                        break;
+                    case eTXPOLICY_FAIL :
+                        bSent=_xTxQueue.send(xItem, 0);
+                        pulFailed=&_xTxStats.ulFailed;
+                        break;
+                    case eTXPOLICY_DROP_OLDEST :
+                        bSent=_xTxQueue.send(xItem, 0);
+                        if (!bSent) {
+                            bool bDropped=false;
+
+                            // make space, TX task may have done so meanwhile.  Scheduler suspended so the item checked is the item
+                            // discarded and no other producer takes the space, queue calls do not block
+                            vTaskSuspendAll();
+                            xOldest=_xTxQueue.peek(bDropped, 0);
+                            if (bDropped && itemDroppable(xOldest)) {
+                                bDropped=_xTxQueue.receive(xOldest, 0);
+                            }else {
+                                bDropped=false;
+                            }
+                            bSent=_xTxQueue.send(xItem, 0);
+                            xTaskResumeAll();
+
+                            pulFailed=&_xTxStats.ulFailed;
+                            pulDropped=bDropped ? &_xTxStats.ulDroppedOldest : NULL;
+                        }
+                        break;
+                    case eTXPOLICY_DROP_NEWEST :
+                        bSent=_xTxQueue.send(xItem, 0);
+                        if (!bSent) {
+                            pulFailed=&_xTxStats.ulFailed;
+                            if (itemDroppable(xItem)) {
+                                pulDropped=&_xTxStats.ulDroppedNewest;
+                                bSent=true;     // reports success
+                                bQueued=false;
+                            }                   // else caller expects completion, fails
+                        }
+                        break;
+                    default :
+                        bSent=sendWait(xItem, portMAX_DELAY);
+                        break;
+                }
+
+                // producers update while other tasks read
+                taskENTER_CRITICAL();
+                if (pulDropped) {
+                    (*pulDropped)++;
+                    _xTxStats.ulDropped++;
+                }
+                if (!bSent) {
+                    if (pulFailed) {
+                        (*pulFailed)++;
+                    }
+                    _xTxStats.ulDropped++;
+                }
+                taskEXIT_CRITICAL();
+
+                if (bSent && bQueued) {
+                    posted();
+                }
+
+                return bSent;
+            }
+
+
+            /**
+             * Send item on TX queue waiting for space.  The task servicing the queue cannot wait for itself so services items to make
+             * space instead, e.g. a \ref cUART observer replying
+             *
+             * \param[in] xItem Reference to item, timestamped
+             * \param[in] xTimeout Ticks to wait, portMAX_DELAY (unlimited)
+             * \return Sent state
+             */
+            bool sendWait(const tTXItem &xItem, const TickType_t xTimeout) {
+                if (!servicing()) {
+                    return _xTxQueue.send(xItem, xTimeout);
+                }
+                while(!_xTxQueue.send(xItem, 0)) {
+                    if (!timeRemaining(xItem.xQueued, xTimeout)) {
+                        return false;
+                    }
+                    serviceBudget(1);
+                }
+
+                return true;
+            }
+
+
+            /**
+             * Item posted on TX queue, servicing task may need waking
+             */
+            virtual void posted() { }
+
+
+            /**
+             * Calling task services the TX queue, waiting on it would deadlock
+             *
+             * \return Servicing state
+             */
+            virtual bool servicing() const {
+                return false;
+            }
+
+
+            /**
+             * Write buffer to UART, via compressor when set
+             *
+             * \param[in] pucData Pointer to data
+             * \param[in] usLength Data length (bytes)
+             */
+            void write(const uint8_t *pucData, const uint16_t usLength) {
+                if (_pxCompress) {
+                    writeCompressed(pucData, usLength);
+                }else {
+                    writeUART(pucData, usLength);
+                }
+            }
+
+
+            /**
+             * Write buffer to UART via compressor, output buffer only on stack when compressing
+             *
+             * \param[in] pucData Pointer to data
+             * \param[in] usLength Data length (bytes)
+             */
+            void writeCompressed(const uint8_t *pucData, uint16_t usLength) {
+                uint8_t ucOut[CCOMPRESS_OUT_MAX(CUARTTX_COMPRESS_CHUNK)];
+                uint16_t usChunk;
+
+                while(usLength) {
+                    usChunk=(usLength>CUARTTX_COMPRESS_CHUNK) ? CUARTTX_COMPRESS_CHUNK : usLength;
+                    writeUART(ucOut, _pxCompress->compress(pucData, usChunk, ucOut));
+                    pucData+=usChunk;
+                    usLength-=usChunk;
+                }
+            }
+
+
+            /**
+             * Half duplex driver enable pin control, override for other hardware or host simulation
+             *
+             * \param[in] bEnable Driver enabled state
+             */
+            virtual void driverEnable(const bool bEnable) {
+                digitalWrite(_ucDEPin, (bEnable==_bDEActiveHigh) ? HIGH : LOW);
+            }
+
+
+            /**
+             * Half duplex, wait for transmit complete then release bus.  Turnaround measured from transmit complete
+             */
+            void driverRelease() {
+                uint32_t ulStart, ulComplete;
+
+                if (_bDE) {
+                    ulStart=nText::cClockMicros::now();
+                    _xTxSerial.flush();     // waits for transmission complete
+                    ulComplete=nText::cClockMicros::now();
+                    driverEnable(false);
+                    _bDE=false;
+                    ulStart=ulComplete-ulStart;
+                    ulComplete=nText::cClockMicros::now()-ulComplete;
+
+                    taskENTER_CRITICAL();
+                    _xTxStats.ulTurnaroundLast=ulComplete;
+                    if (_xTxStats.ulTurnaroundLast>_xTxStats.ulTurnaroundMax) {
+                        _xTxStats.ulTurnaroundMax=_xTxStats.ulTurnaroundLast;
+                    }
+                    if (ulStart>_xTxStats.ulDrainMax) {
+                        _xTxStats.ulDrainMax=ulStart;
+                    }
+                    _xTxStats.ulTurnarounds++;
+                    taskEXIT_CRITICAL();
+                }
+            }
+
+
+            /**
+             * TX queue idle, end compressor block and release half duplex bus
+             */
+            void idle() {
+                blockEnd();
+                driverRelease();
+            }
+
+
+            /**
+             * End compressor block, written so far is decodable
+             */
+            void blockEnd() {
+                uint8_t ucOut[CCOMPRESS_END_MAX];
+
+                if (_pxCompress) {
+                    writeUART(ucOut, _pxCompress->end(ucOut));
+                }
+            }
+
+
+            /**
+             * Write buffer to UART in chunks its TX buffer accepts without blocking.  When full the remainder is written blocking
+             *
+             * \note Define CUARTTX_NO_AVAILABLEFORWRITE for cores whose HardwareSerial lacks availableForWrite(), always blocking
+             * \param[in] pucData Pointer to data
+             * \param[in] usLength Data length (bytes)
+             */
+            void writeUART(const uint8_t *pucData, uint16_t usLength) {
+                TickType_t xStart=xTaskGetTickCount();
+                uint16_t usChunk;
+
+                // half duplex, take bus
+                if (!_bDE && usLength && CUARTTX_NO_PIN!=_ucDEPin) {
+                    driverEnable(true);
+                    _bDE=true;
+                }
+
+                while(usLength) {
+                    usChunk=usLength;
+#if !defined(CUARTTX_NO_AVAILABLEFORWRITE)
+                    int iSpace=_xTxSerial.availableForWrite();
+
+                    if (iSpace>0 && iSpace<usChunk) {
+                        usChunk=static_cast<uint16_t>(iSpace);
+                    }
+#endif
+                    usChunk=static_cast<uint16_t>(_xTxSerial.write(pucData, usChunk));
+                    if (!usChunk) {
+                        break;      // write error, give up on rest
+                    }
+                    pucData+=usChunk;
+                    usLength-=usChunk;
+                }
+                blocked(xStart);
+            }
+
+
+            /**
+             * Service TX queue.  Read an item and output line over hardware UART, when coalescing carry on reading items into staging
+             * buffer until it is full, the queue is empty, hold time expires or ucItemMax items are read
+             *
+             * \param[in] xTicksToWait Ticks to wait for an item
+             * \param[in] ucItemMax Maximum items when coalescing, 0 no limit.  Default 0
+             * \return Item serviced state
+             */
+            bool service(const TickType_t xTicksToWait, const uint8_t ucItemMax = 0) {
+                tTXItem data;
+                TickType_t xStart, xWait;
+                uint8_t ucItems=0;
+
+                // Wait for tx data, is it ok?
+                if (!_xTxQueue.receive(data, xTicksToWait)) {
+                    return false;
+                }
+
+                if (!_pucStage) {
+                    // Send over serial
+                    if (eTXITEM_FLUSH!=data.ucType) {
+                        itemWrite(data);
+                        burstAdd(data);
+                        burstEnd();
+                    }
+                    itemDone(data);
+                    if (!_xTxQueue.getMessagesWaiting()) {
+                        idle();
+                    }
+                    return true;
+                }
+
+                xStart=xTaskGetTickCount();
+                do {
+                    if (eTXITEM_FLUSH!=data.ucType) {
+                        uint16_t l=itemLength(data);
+
+                        // no room?  write what is staged, lines bigger than staging go direct
+                        if (_usStaged+l>_usStageSize) {
+                            stageFlush();
+                        }
+                        if (l>_usStageSize) {
+                            itemWrite(data);
+                        }else {
+                            itemCopy(&_pucStage[_usStaged], data);
+                            _usStaged+=l;
+                        }
+                        burstAdd(data);
+                    }
+                    // flushing or someone waiting?  end burst early
+                    if (eTXITEM_FLUSH==data.ucType || data.xNotify || itemComplete(data)) {
+                        stageFlush();
+                        itemDone(data);
+                    }
+
+                    // more within hold time and budget?
+                    if (ucItemMax && ++ucItems>=ucItemMax) {
+                        break;
+                    }
+                    xWait=xTaskGetTickCount()-xStart;
+                    xWait=(xWait<_xHold) ? _xHold-xWait : 0;
+                }while(_xTxQueue.receive(data, xWait));
+
+                stageFlush();
+                blockEnd();
+                if (!_xTxQueue.getMessagesWaiting()) {
+                    driverRelease();
+                }
+
+                return true;
+            }
+
+
+            /**
+             * Service TX queue without waiting for items, at most ucItemMax so a task that also receives gets back to it
+             *
+             * \param[in] ucItemMax Maximum items
+             * \return Items serviced state
+             */
+            bool serviceBudget(const uint8_t ucItemMax) {
+                uint8_t ucI;
+
+                if (_pucStage) {
+                    return service(0, ucItemMax);
+                }
+                for(ucI=0;ucI<ucItemMax && service(0);ucI++);
+
+                return ucI>0;
+            }
+
+
+            /**
+             * Get item length
+             *
+             * \param[in] xItem Reference to item
+             * \return Length (bytes)
+             */
+            uint16_t itemLength(const tTXItem &xItem) const {
+                uint16_t usI, usLength=0;
+
+                switch(xItem.ucType) {
+                    case eTXITEM_LINE :
+                        return xItem.xLine.getLineLength();
+                    case eTXITEM_SEGMENTS :
+                        for(usI=0;usI<xItem.xRef.usRefLength;usI++) {
+                            usLength+=xItem.xRef.pxSegments[usI].usLength;
+                        }
+                        return usLength;
+                    default :
+                        return xItem.xRef.usRefLength;
+                }
+            }
+
+
+            /**
+             * Copy item content
+             *
+             * \param[out] pucOut Pointer to buffer, \ref itemLength bytes
+             * \param[in] xItem Reference to item
+             */
+            void itemCopy(uint8_t *pucOut, const tTXItem &xItem) const {
+                uint16_t usI;
+
+                switch(xItem.ucType) {
+                    case eTXITEM_FLASH :
+                        memcpy_P(pucOut, xItem.xRef.pscRef, xItem.xRef.usRefLength);
+                        break;
+                    case eTXITEM_STATIC :
+                        memcpy(pucOut, xItem.xRef.pscRef, xItem.xRef.usRefLength);
+                        break;
+                    case eTXITEM_SEGMENTS :
+                        for(usI=0;usI<xItem.xRef.usRefLength;usI++) {
+                            memcpy(pucOut, xItem.xRef.pxSegments[usI].pucData, xItem.xRef.pxSegments[usI].usLength);
+                            pucOut+=xItem.xRef.pxSegments[usI].usLength;
+                        }
+                        break;
+                    default :
+                        memcpy(pucOut, xItem.xLine.getLine(), xItem.xLine.getLineLength());
+                        break;
+                }
+            }
+
+
+            /**
+             * Write item content to UART, flash strings via small buffer on stack
+             *
+             * \param[in] xItem Reference to item
+             */
+            void itemWrite(const tTXItem &xItem) {
+                uint8_t ucChunk[CUARTTX_FLASH_CHUNK];
+                uint16_t usI, usLength;
+
+                switch(xItem.ucType) {
+                    case eTXITEM_FLASH :
+                        for(usI=0;usI<xItem.xRef.usRefLength;usI+=usLength) {
+                            usLength=xItem.xRef.usRefLength-usI;
+                            if (usLength>sizeof(ucChunk)) {
+                                usLength=sizeof(ucChunk);
+                            }
+                            memcpy_P(ucChunk, &xItem.xRef.pscRef[usI], usLength);
+                            write(ucChunk, usLength);
+                        }
+                        break;
+                    case eTXITEM_STATIC :
+                        write(reinterpret_cast<const uint8_t*>(xItem.xRef.pscRef), xItem.xRef.usRefLength);
+                        break;
+                    case eTXITEM_SEGMENTS :
+                        for(usI=0;usI<xItem.xRef.usRefLength;usI++) {
+                            write(xItem.xRef.pxSegments[usI].pucData, xItem.xRef.pxSegments[usI].usLength);
+                        }
+                        break;
+                    default :
+                        write(reinterpret_cast<const uint8_t*>(xItem.xLine.getLine()), xItem.xLine.getLineLength());
+                        break;
+                }
+            }
+
+
+            /**
+             * Item written, flush UART for flush marker, invoke callback and notify waiting task
+             *
+             * \param[in] xItem Reference to item
+             */
+            void itemDone(const tTXItem &xItem) {
+                if (eTXITEM_FLUSH==xItem.ucType || itemComplete(xItem) || xItem.xNotify) {
+                    blockEnd();
+                }
+                if (eTXITEM_FLUSH==xItem.ucType) {
+                    TickType_t xStart=xTaskGetTickCount();
+
+                    _xTxSerial.flush();     // waits for transmission complete
+                    blocked(xStart);
+                }
+                if (itemComplete(xItem)) {
+                    xItem.xRef.pfComplete(xItem.xRef.pvContext);
+                }
+                if (xItem.xNotify) {
+                    xTaskNotifyGive(xItem.xNotify);
+                }
+                if (eTXITEM_FLUSH==xItem.ucType) {
+                    _usFlushed=xItem.xRef.usRefLength;
+                    xSemaphoreGive(_xFlushDone);
+                }
+            }
+
+
+            /**
+             * Write staged lines, ends burst
+             */
+            void stageFlush() {
+                if (_usStaged) {
+                    write(_pucStage, _usStaged);
+                    _usStaged=0;
+                }
+                burstEnd();
+            }
+
+
+            /**
+             * Account for item written (or staged) in current burst
+             *
+             * \param[in] xItem Reference to item
+             */
+            void burstAdd(const tTXItem &xItem) {
+                // queue is FIFO so first of burst is oldest
+                if (!_usBurstLines) {
+                    _xBurstOldest=xItem.xQueued;
+                }
+                _ulBurstQueued+=xItem.xQueued;
+                _usBurstLines++;
+                taskENTER_CRITICAL();
+                _xTxStats.ulBytes+=itemLength(xItem);
+                taskEXIT_CRITICAL();
+            }
+
+
+            /**
+             * Account time TX task blocked writing
+             *
+             * \param[in] xStart Block start (ticks)
+             */
+            void blocked(const TickType_t xStart) {
+                TickType_t xBlocked=xTaskGetTickCount()-xStart;
+
+                taskENTER_CRITICAL();
+                _xTxStats.xTicksBlocked+=xBlocked;
+                taskEXIT_CRITICAL();
+            }
+
+
+            /**
+             * Burst written, account line latencies
+             */
+            void burstEnd() {
+                TickType_t xNow=xTaskGetTickCount();
+
+                if (_usBurstLines) {
+                    taskENTER_CRITICAL();
+                    _xTxStats.ulLatencySum+=static_cast<uint32_t>(xNow)*_usBurstLines-_ulBurstQueued;
+                    if (xNow-_xBurstOldest>_xTxStats.xLatencyMax) {
+                        _xTxStats.xLatencyMax=xNow-_xBurstOldest;
+                    }
+                    _xTxStats.ulLines+=_usBurstLines;
+                    _xTxStats.ulBursts++;
+                    if (_usBurstLines>_xTxStats.usBurstLinesMax) {
+                        _xTxStats.usBurstLinesMax=_usBurstLines;
+                    }
+                    taskEXIT_CRITICAL();
+                    _usBurstLines=0;
+                    _ulBurstQueued=0;
+                }
+            }
+
+        protected:
+            HardwareSerial&                        _xTxSerial;
+            nFRTOS::cQueue<tTXItem>                _xTxQueue;
+            tTXStats                               _xTxStats;
+            uint8_t*                               _pucStage;           ///< Coalescing staging buffer or NULL
+            uint16_t                               _usStageSize;        ///< Staging buffer size (bytes)
+            TickType_t                             _xHold;              ///< Coalescing hold time (ticks)
+            uint16_t                               _usStaged;           ///< Bytes staged
+            uint16_t                               _usBurstLines;       ///< Lines in current burst
+            uint32_t                               _ulBurstQueued;      ///< Sum of queued timestamps of lines in current burst
+            TickType_t                             _xBurstOldest;       ///< Oldest queued timestamp of lines in current burst
+            eTXPOLICY                              _ePolicy;            ///< Backpressure policy
+            TickType_t                             _xPolicyTimeout;     ///< \ref eTXPOLICY_TIMEOUT wait (ticks)
+            nText::cCompress*                      _pxCompress;         ///< Compressor or NULL
+            uint8_t                                _ucDEPin;            ///< Half duplex driver enable pin or CUARTTX_NO_PIN
+            bool                                   _bDEActiveHigh;      ///< Driver enabled level
+            bool                                   _bDE;                ///< Driver enabled state
+            SemaphoreHandle_t                      _xFlushDone;         ///< Given when a flush marker is written
+            SemaphoreHandle_t                      _xFlushLock;         ///< Serialises \ref flush callers
+            uint16_t                               _usFlushSequence;    ///< Last flush marker sequence posted
+            volatile uint16_t                      _usFlushed;          ///< Last flush marker sequence written
+    }; // class cUARTTXEngine
+
+
+    /**
+     * A wrapper class for an Arduino hardware UART TX operation that is FRTOS task friendly using queues
+     *
+     * \tparam N Text line length (characters, including NULL)
+     */
+    template <uint16_t N>
+    class cUARTTX : public nFRTOS::cTask, public cUARTTXEngine<N> {
+        public:
+            /**
+             * Constructor.  Make stable instance
+             *
+             * \param[in] xSerial Reference to Ardiuno hardware serial port instance, used to receive data
+             * \param ucQueueSize in cTextLine objects
+             */
+            cUARTTX(HardwareSerial &xSerial, const uint8_t ucQueueSize) : cUARTTXEngine<N>(xSerial, ucQueueSize) {
+            }
+
+
+            /**
+             * Create task and start it + create queue
+             *
+             * \note Originally setup task name as "UArtT<tx pin>" but no debugger for arduino code so no point
+             * \return Join and queue state
+             */
+            bool join(const UBaseType_t priority = tskIDLE_PRIORITY + 1, const uint32_t stackSize=configMINIMAL_STACK_SIZE * 4) {
+                if (!isValidHandle()) {
+                    start(NULL, priority, stackSize);
+
+                    cUARTTXEngine<N>::createQueue();
+                }
+
+                return isValidHandle() && cUARTTXEngine<N>::isQueueValid();
+            }
+
+        protected:
+
+            /**
+             * Transmit task loop.  Read TX queue and output line over hardware UART
+             */
+            void run() {
+                for (;;) {
+                    // Wait for tx data (endlessly)
+                    cUARTTXEngine<N>::service(portMAX_DELAY);
+                }
+            }
+    }; // class cUARTTX
+
+
+    /**
+     * A class combining \ref cUARTRX and \ref cUARTTX for a full-duplex Arduino hardware UART serviced by a single FRTOS task, saves
+     * a task stack.  The task waits on its notification, given by transmit, \ref cUARTRX::signal or \ref cUARTRX::release, or the
+     * receive delay, whichever comes first.  Observers run on this task, the only one draining the TX queue, so when they transmit a
+     * reply and the queue is full the blocking policies service queued items in the call rather than wait.  Receive is held off
+     * meanwhile, use \ref cUARTTXEngine::eTXPOLICY_FAIL where that matters
+     *
+     * \tparam N Text line length (characters, including NULL)
+     * \tparam F Framing engine class, see \ref cUARTRX
+     * \tparam D Line buffers, see \ref cUARTRX
+     */
+    template <uint16_t N, class F = nText::cFramerCRLF, uint8_t D = 1>
+    class cUART : public cUARTRX<N, F, D>, public cUARTTXEngine<N> {
+        public:
+            /**
+             * Constructor.  Make stable instance
+             *
+             * \param[in] xSerial Reference to Ardiuno hardware serial port instance, used to receive and transmit data
+             * \param[in] ucQueueSize TX queue size in cTextLine objects
+             * \param[in] ucRXDelay Receive delay (ticks), see \ref cUARTRX.  Transmit wakes the task early
+             * \param[in] eMode Receive mode, see \ref cUARTRX
+             */
+            cUART(HardwareSerial &xSerial, const uint8_t ucQueueSize, uint8_t ucRXDelay=5,
+                        const typename cUARTRX<N, F, D>::eRXMODE eMode=cUARTRX<N, F, D>::eRXMODE_POLL) :
+                                                    cUARTRX<N, F, D>(xSerial, ucRXDelay, eMode), cUARTTXEngine<N>(xSerial, ucQueueSize) {
+            }
+
+
+            /**
+             * Create task and start it + create queue
+             *
+             * \param[in] priority Task priority level, default +1 above idle
+             * \param[in] stackSize Task stack size (Bytes), default 4 * configMINIMAL_STACK_SIZE
+             * \return Join and queue state
+             */
+            bool join(const UBaseType_t priority = tskIDLE_PRIORITY + 1, const uint32_t stackSize=configMINIMAL_STACK_SIZE * 4) {
+                if (!nFRTOS::cTask::isValidHandle()) {
+                    cUARTTXEngine<N>::createQueue();
+
+                    nFRTOS::cTask::start(NULL, priority, stackSize);
+                }
+
+                return nFRTOS::cTask::isValidHandle() && cUARTTXEngine<N>::isQueueValid();
+            }
+
+
+            /**
+             * Get receive statistics
+             *
+             * \return Copy of statistics
+             */
+            typename cUARTRX<N, F, D>::tRXStats getRXStats() const {
+                return cUARTRX<N, F, D>::getStats();
+            }
+
+
+            /**
+             * Get transmit statistics
+             *
+             * \return Copy of statistics
+             */
+            typename cUARTTXEngine<N>::tTXStats getTXStats() const {
+                return cUARTTXEngine<N>::getStats();
+            }
+
+
+            /**
+             * Reset receive statistics
+             */
+            void resetRXStats() {
+                cUARTRX<N, F, D>::resetStats();
+            }
+
+
+            /**
+             * Reset transmit statistics
+             */
+            void resetTXStats() {
+                cUARTTXEngine<N>::resetStats();
+            }
+
+        protected:
+            /**
+             * Item posted on TX queue, wake task
+             */
+            void posted() {
+                nFRTOS::cTask::notifyGive();
+            }
+
+
+            /**
+             * Calling task is this task, e.g. an observer transmitting a reply
+             *
+             * \return Servicing state
+             */
+            bool servicing() const {
+                return xTaskGetCurrentTaskHandle()==nFRTOS::cTask::_xTHandle;
+            }
+
+
+            /**
+             * Receive delay, waits for notification so transmit is serviced promptly
+             *
+             * \param[in] xTicks Delay (ticks)
+             */
+            void delay(const TickType_t xTicks) {
+                if (xTicks && !cUARTTXEngine<N>::_xTxQueue.getMessagesWaiting()) {
+                    wait(xTicks);
+                }else {
+                    taskYIELD();
+                    cUARTTXEngine<N>::serviceBudget(CUART_TX_BUDGET);
+                }
+            }
+
+
+            /**
+             * Receive wait for notification, then service transmit
+             *
+             * \param[in] xTicks Maximum wait (ticks)
+             */
+            void wait(const TickType_t xTicks) {
+                // transmit left over from last budget?  poll only
+                nFRTOS::cTask::notifyTake(cUARTTXEngine<N>::_xTxQueue.getMessagesWaiting() ? 0 : xTicks);
+                cUARTTXEngine<N>::serviceBudget(CUART_TX_BUDGET);
+            }
+
+
+            /**
+             * Task loop.  Transmit up to \ref CUART_TX_BUDGET queued items, read lines and notify any listeners
+             */
+            void run() {
+                cUARTRX<N, F, D>::_xRegimeTick=xTaskGetTickCount();
+                for (;;) {
+                    cUARTTXEngine<N>::serviceBudget(CUART_TX_BUDGET);
+
+                    if (nText::cTexter<N, F>::readLine(this, *cUARTRX<N, F, D>::getLineBuffer(cUARTRX<N, F, D>::_ucFill))) {
+                        cUARTRX<N, F, D>::lineComplete();
+                    }else {
+                        cUARTRX<N, F, D>::characterReadDelay();
+                    }
+                }
+            }
+    }; // class cUART
+
+
+    /**
+     * A class implementing a token bucket, limits a byte stream to a rate with bursts.  Tokens refill from the FRTOS tick count so
+     * no task or timer is needed.  Task safe
+     */
+    class cTokenBucket {
+        public:
+            /**
+             * Throttle statistics, \ref getStats
+             */
+            typedef struct {
+                uint32_t        ulPassed;           ///< Requests within limit
+                uint32_t        ulThrottled;        ///< Requests refused
+                uint32_t        ulThrottledBytes;   ///< Bytes refused
+                uint32_t        ulRefunded;         ///< Requests passed then refunded, \ref refund
+            }tTBStats;
+
+
+            /**
+             * Constructor.  Make stable instance, full bucket
+             *
+             * \param[in] ulRate Refill rate (bytes/s), 0 unlimited
+             * \param[in] usBurst Bucket size, largest burst (bytes)
+             */
+            cTokenBucket(const uint32_t ulRate=0, const uint16_t usBurst=0) {
+                setRate(ulRate, usBurst);
+                memset(&_xStats, 0, sizeof(_xStats));
+            }
+
+
+            /**
+             * Set rate and burst, bucket refilled
+             *
+             * \param[in] ulRate Refill rate (bytes/s), 0 unlimited
+             * \param[in] usBurst Bucket size, largest burst (bytes)
+             */
+            void setRate(const uint32_t ulRate, const uint16_t usBurst) {
+                taskENTER_CRITICAL();
+                _ulRate=ulRate;
+                _ulCapacity=static_cast<uint32_t>(usBurst)*configTICK_RATE_HZ;
+                _ulTokens=_ulCapacity;
+                _xLast=xTaskGetTickCount();
+                taskEXIT_CRITICAL();
+            }
+
+
+            /**
+             * Take tokens for bytes, all or none
+             *
+             * \param[in] usBytes Byte count
+             * \return Within limit state
+             */
+            bool take(const uint16_t usBytes) {
+                uint32_t ulNeed=static_cast<uint32_t>(usBytes)*configTICK_RATE_HZ;
+                TickType_t xNow, xElapsed;
+                bool bPass=true;
+
+                taskENTER_CRITICAL();
+                if (_ulRate) {
+                    // refill, tokens held in bytes*ticks/s so slow rates do not round away
+                    xNow=xTaskGetTickCount();
+                    xElapsed=xNow-_xLast;
+                    _xLast=xNow;
+                    if (xElapsed>(_ulCapacity-_ulTokens)/_ulRate) {
+                        _ulTokens=_ulCapacity;
+                    }else {
+                        _ulTokens+=xElapsed*_ulRate;
+                    }
+                    if (ulNeed>_ulTokens) {
+                        bPass=false;
+                    }else {
+                        _ulTokens-=ulNeed;
+                    }
+                }
+                if (bPass) {
+                    _xStats.ulPassed++;
+                }else {
+                    _xStats.ulThrottled++;
+                    _xStats.ulThrottledBytes+=usBytes;
+                }
+                taskEXIT_CRITICAL();
+
+                return bPass;
+            }
+
+
+            /**
+             * Return tokens taken for bytes that were not sent after all, e.g. queue full
+             *
+             * \param[in] usBytes Byte count, as given to \ref take
+             */
+            void refund(const uint16_t usBytes) {
+                uint32_t ulRefund=static_cast<uint32_t>(usBytes)*configTICK_RATE_HZ;
+
+                taskENTER_CRITICAL();
+                if (_ulRate) {
+                    _ulTokens=(ulRefund>_ulCapacity-_ulTokens) ? _ulCapacity : _ulTokens+ulRefund;
+                }
+                _xStats.ulRefunded++;
+                taskEXIT_CRITICAL();
+            }
+
+
+            /**
+             * Get throttle statistics
+             *
+             * \return Copy of statistics
+             */
+            tTBStats getStats() const {
+                tTBStats xStats;
+
+                // producers update, copy whole so 32 bit counters do not tear
+                taskENTER_CRITICAL();
+                xStats=_xStats;
+                taskEXIT_CRITICAL();
+
+                return xStats;
+            }
+
+
+            /**
+             * Reset throttle statistics
+             */
+            void resetStats() {
+                taskENTER_CRITICAL();
+                memset(&_xStats, 0, sizeof(_xStats));
+                taskEXIT_CRITICAL();
+            }
+
+        protected:
+            uint32_t            _ulRate;            ///< Refill rate (bytes/s)
+            uint32_t            _ulCapacity;        ///< Bucket size (bytes*configTICK_RATE_HZ)
+            uint32_t            _ulTokens;          ///< Tokens (bytes*configTICK_RATE_HZ)
+            TickType_t          _xLast;             ///< Last refill timestamp (ticks)
+            tTBStats            _xStats;
+    }; // class cTokenBucket
+
+
+    /**
+     * A class implementing a rate limited TX channel, one per producer so a chatty task cannot monopolise a shared TX queue.  Same
+     * transmit API as \ref cUARTTXEngine, lines over the channel limit are refused and counted rather than queued.  Tokens of lines
+     * the engine does not queue are refunded, so \ref cUARTTXEngine::eTXPOLICY_DROP_NEWEST is applied as
+     * \ref cUARTTXEngine::eTXPOLICY_FAIL (engine counts ulFailed) and still reports success, except for segments which report failure
+     *
+     * \tparam T TX engine class, \ref cUARTTX or \ref cUART
+     */
+    template <class T>
+    class cUARTTXChannel {
+        public:
+            /**
+             * Longest line transmitted whole (characters), that of the engine
+             */
+            enum {
+                eTX_LINE_MAX    = T::eTX_LINE_MAX
+            };
+
+
+            /**
+             * Constructor.  Make stable instance
+             *
+             * \param[in] xTX Reference to shared TX engine
+             * \param[in] ulRate Channel rate (bytes/s), 0 unlimited
+             * \param[in] usBurst Channel burst (bytes)
+             */
+            cUARTTXChannel(T &xTX, const uint32_t ulRate, const uint16_t usBurst) : _xTX(xTX), _xBucket(ulRate, usBurst) { }
+
+
+            /**
+             * Transmit given cTextLine over UART when within channel limit
+             *
+             * \tparam N Text line length (characters, including NULL)
+             * \param[in] xTextLine Reference to instance of text line to send
+             * \param[in] ePolicy Backpressure policy, \ref cUARTTXEngine::setBackpressure
+             * \param[in] xTimeout \ref cUARTTXEngine::eTXPOLICY_TIMEOUT wait (ticks)
+             * \return Transmit success or failure, false when throttled
+             */
+            template <uint16_t N>
+            bool transmit(nText::cTextLine<N> &xTextLine, const typename T::eTXPOLICY ePolicy=T::eTXPOLICY_INSTANCE,
+                                                                                                const TickType_t xTimeout=0) {
+                bool bDropNewest;
+                const typename T::eTXPOLICY eSend=policy(ePolicy, bDropNewest);
+
+                return _xBucket.take(xTextLine.getLineLength()) &&
+                                                sent(_xTX.transmit(xTextLine, eSend, xTimeout), xTextLine.getLineLength(), bDropNewest);
+            }
+
+
+            /**
+             * Transmit given character string over UART when within channel limit
+             *
+             * \param[in] pscTextLine Null terminated character string pointer
+             * \param[in] ePolicy Backpressure policy, \ref cUARTTXEngine::setBackpressure
+             * \param[in] xTimeout \ref cUARTTXEngine::eTXPOLICY_TIMEOUT wait (ticks)
+             * \return Transmit success or failure, false when throttled
+             */
+            bool transmit(const char *pscTextLine, const typename T::eTXPOLICY ePolicy=T::eTXPOLICY_INSTANCE, const TickType_t xTimeout=0) {
+                return transmit(pscTextLine, static_cast<uint8_t>(strlen(pscTextLine)), ePolicy, xTimeout);
+            }
+
+
+            /**
+             * Transmit given fixed length character string over UART when within channel limit
+             *
+             * \param[in] pscTextLine Character string pointer
+             * \param ucLength Length of string in characters, should not include NULL terminator
+             * \param[in] ePolicy Backpressure policy, \ref cUARTTXEngine::setBackpressure
+             * \param[in] xTimeout \ref cUARTTXEngine::eTXPOLICY_TIMEOUT wait (ticks)
+             * \return Transmit success or failure, false when throttled
+             */
+            bool transmit(const char *pscTextLine, const uint8_t ucLength, const typename T::eTXPOLICY ePolicy=T::eTXPOLICY_INSTANCE,
+                                                                                                const TickType_t xTimeout=0) {
+                bool bDropNewest;
+                const typename T::eTXPOLICY eSend=policy(ePolicy, bDropNewest);
+
+                return _xBucket.take(ucLength) && sent(_xTX.transmit(pscTextLine, ucLength, eSend, xTimeout), ucLength, bDropNewest);
+            }
+
+
+            /**
+             * Transmit given flash character string over UART when within channel limit
+             *
+             * \param[in] pxTextLine Pointer to flash (PROGMEM) null terminated character string, must remain valid
+             * \param[in] ePolicy Backpressure policy, \ref cUARTTXEngine::setBackpressure
+             * \param[in] xTimeout \ref cUARTTXEngine::eTXPOLICY_TIMEOUT wait (ticks)
+             * \return Transmit success or failure, false when throttled
+             */
+            bool transmit(const __FlashStringHelper *pxTextLine, const typename T::eTXPOLICY ePolicy=T::eTXPOLICY_INSTANCE,
+                                                                                                const TickType_t xTimeout=0) {
+                const uint16_t usLength=static_cast<uint16_t>(strlen_P(reinterpret_cast<const char*>(pxTextLine)));
+                bool bDropNewest;
+                const typename T::eTXPOLICY eSend=policy(ePolicy, bDropNewest);
+
+                return _xBucket.take(usLength) && sent(_xTX.transmit(pxTextLine, eSend, xTimeout), usLength, bDropNewest);
+            }
+
+
+            /**
+             * Transmit given immutable character string over UART when within channel limit, no copy
+             *
+             * \param[in] pscText Pointer to character string, must remain valid and unchanged until written
+             * \param[in] usLength Length of string in characters
+             * \param[in] ePolicy Backpressure policy, \ref cUARTTXEngine::setBackpressure
+             * \param[in] xTimeout \ref cUARTTXEngine::eTXPOLICY_TIMEOUT wait (ticks)
+             * \return Transmit success or failure, false when throttled
+             */
+            bool transmitStatic(const char *pscText, const uint16_t usLength, const typename T::eTXPOLICY ePolicy=T::eTXPOLICY_INSTANCE,
+                                                                                                const TickType_t xTimeout=0) {
+                bool bDropNewest;
+                const typename T::eTXPOLICY eSend=policy(ePolicy, bDropNewest);
+
+                return _xBucket.take(usLength) && sent(_xTX.transmitStatic(pscText, usLength, eSend, xTimeout), usLength, bDropNewest);
+            }
+
+
+            /**
+             * Transmit segments in order over UART when within channel limit, \ref cUARTTXEngine::transmitSegments
+             *
+             * \param[in] pxSegments Pointer to segment list, must remain valid until completion
+             * \param[in] ucCount Segment count
+             * \param[in] pfComplete Completion callback or NULL
+             * \param[in] pvContext Callback context
+             * \param[in] xNotify Task to notify on completion or NULL
+             * \param[in] ePolicy Backpressure policy, \ref cUARTTXEngine::setBackpressure
+             * \param[in] xTimeout \ref cUARTTXEngine::eTXPOLICY_TIMEOUT wait (ticks)
+             * \return Transmit success or failure, false when throttled
+             */
+            bool transmitSegments(const typename T::tTXSegment *pxSegments, const uint8_t ucCount,
+                                        const typename T::tTXComplete pfComplete=NULL, void *pvContext=NULL, const TaskHandle_t xNotify=NULL,
+                                        const typename T::eTXPOLICY ePolicy=T::eTXPOLICY_INSTANCE, const TickType_t xTimeout=0) {
+                uint16_t usLength=0;
+                bool bDropNewest;
+                const typename T::eTXPOLICY eSend=policy(ePolicy, bDropNewest);
+
+                for(uint8_t ucI=0;ucI<ucCount;ucI++) {
+                    usLength+=pxSegments[ucI].usLength;
+                }
+
+                // dropped segments give no completion, so report failure rather than drop newest success
+                return _xBucket.take(usLength) && sent(_xTX.transmitSegments(pxSegments, ucCount, pfComplete, pvContext, xNotify, eSend,
+                                                                                                        xTimeout), usLength, false);
+            }
+
+
+            /**
+             * Wait until shared TX engine has flushed, \ref cUARTTXEngine::flush
+             *
+             * \param[in] xTimeout Ticks to wait.  Default portMAX_DELAY (unlimited)
+             * \return Flushed state, false on timeout
+             */
+            bool flush(const TickType_t xTimeout=portMAX_DELAY) {
+                return _xTX.flush(xTimeout);
+            }
+
+
+            /**
+             * Get channel token bucket, rate changes and throttle statistics
+             *
+             * \return Reference to bucket
+             */
+            cTokenBucket &getBucket() {
+                return _xBucket;
+            }
+
+        protected:
+            /**
+             * Policy passed to engine, drop newest becomes fail so a dropped line is seen and refunded
+             *
+             * \param[in] ePolicy Policy given to transmit
+             * \param[out] bDropNewest Drop newest in effect state
+             * \return Policy for engine
+             */
+            typename T::eTXPOLICY policy(const typename T::eTXPOLICY ePolicy, bool &bDropNewest) const {
+                bDropNewest=(T::eTXPOLICY_DROP_NEWEST==((T::eTXPOLICY_INSTANCE==ePolicy) ? _xTX.getBackpressure() : ePolicy));
+
+                return bDropNewest ? T::eTXPOLICY_FAIL : ePolicy;
+            }
+
+
+            /**
+             * Engine transmit result, refund tokens when not queued
+             *
+             * \param[in] bSent Engine transmit result
+             * \param[in] usBytes Bytes taken from bucket
+             * \param[in] bDropNewest Drop newest in effect state, not queued is then success
+             * \return Transmit success or failure
+             */
+            bool sent(const bool bSent, const uint16_t usBytes, const bool bDropNewest) {
+                if (!bSent) {
+                    _xBucket.refund(usBytes);
+                }
+
+                return bSent || bDropNewest;
+            }
+
+        protected:
+            T&                  _xTX;
+            cTokenBucket        _xBucket;
+    }; // class cUARTTXChannel
+
+
+    /**
+     * A class reporting UART link rates periodically, built upon observer design pattern.  Observers are notified every period and use
+     * \ref getRates with \ref cUARTRX and \ref cUARTTX getStats for other counters
+     *
+     * \tparam RX Receive class, a \ref cUARTRX or \ref cUART
+     * \tparam TX Transmit class, a \ref cUARTTX or \ref cUART
+     */
+    template <class RX, class TX>
+    class cUARTReporter : public nFRTOSExt::cObservedTask {
+        public:
+            /**
+             * Link rates, \ref getRates
+             */
+            typedef struct {
+                uint32_t        ulRXBytes;          ///< Receive bytes per second
+                uint32_t        ulRXLines;          ///< Receive lines per second
+                uint32_t        ulTXBytes;          ///< Transmit bytes per second
+                uint32_t        ulTXLines;          ///< Transmit lines per second
+                uint32_t        ulRXBytesPeak;      ///< Peak receive bytes per second
+                uint32_t        ulRXLinesPeak;      ///< Peak receive lines per second
+                uint32_t        ulTXBytesPeak;      ///< Peak transmit bytes per second
+                uint32_t        ulTXLinesPeak;      ///< Peak transmit lines per second
+            }tLinkRates;
+
+
+            /**
+             * Constructor.  Make stable instance
+             *
+             * \param[in] pxRX Pointer to receive instance or NULL
+             * \param[in] pxTX Pointer to transmit instance or NULL
+             * \param[in] xPeriod Report period (ticks)
+             * \param[in] ulEvent Event numeric, a value used to distinguish this event.  Default 0
+             */
+            cUARTReporter(RX *pxRX, TX *pxTX, const TickType_t xPeriod, const uint32_t ulEvent = 0UL) : nFRTOSExt::cObservedTask(ulEvent),
+                                                                    _pxRX(pxRX), _pxTX(pxTX), _xPeriod(xPeriod) {
+                memset(&_xRates, 0, sizeof(_xRates));
+            }
+
+
+            /**
+             * Create task and start it
+             *
+             * \param[in] priority Task priority level, default +1 above idle
+             * \param[in] stackSize Task stack size (Bytes), default 2 * configMINIMAL_STACK_SIZE
+             * \return Join state
+             */
+            bool join(const UBaseType_t priority = tskIDLE_PRIORITY + 1, const uint32_t stackSize=configMINIMAL_STACK_SIZE * 2) {
+                if (!isValidHandle()) {
+                    start(NULL, priority, stackSize);
+                }
+
+                return isValidHandle();
+            }
+
+
+            /**
+             * Get link rates of last period
+             *
+             * \return Copy of rates
+             */
+            tLinkRates getRates() const {
+                return _xRates;
+            }
+
+        protected:
+            /**
+             * Rate per second of counter change, tracks peak
+             *
+             * \param[in] ulCount Counter now
+             * \param[in,out] ulLast Counter at last report
+             * \param[in] xElapsed Ticks since last report
+             * \param[out] ulRate Rate per second
+             * \param[in,out] ulPeak Peak rate per second
+             */
+            static void rate(const uint32_t ulCount, uint32_t &ulLast, const TickType_t xElapsed, uint32_t &ulRate, uint32_t &ulPeak) {
+                ulRate=((ulCount-ulLast)*configTICK_RATE_HZ)/xElapsed;
+                ulLast=ulCount;
+                if (ulRate>ulPeak) {
+                    ulPeak=ulRate;
+                }
+            }
+
+
+            /**
+             * Receive rates, by base class so a \ref cUART (both bases have getStats) resolves
+             *
+             * \param[in] pxRX Pointer to receive instance
+             * \param[in,out] ulBytes Bytes at last report
+             * \param[in,out] ulLines Lines at last report
+             * \param[in] xElapsed Ticks since last report
+             */
+            template <uint16_t N, class F, uint8_t D>
+            void rateRX(const cUARTRX<N, F, D> *pxRX, uint32_t &ulBytes, uint32_t &ulLines, const TickType_t xElapsed) {
+                typename cUARTRX<N, F, D>::tRXStats xStats=pxRX->getStats();
+
+                rate(xStats.ulBytes, ulBytes, xElapsed, _xRates.ulRXBytes, _xRates.ulRXBytesPeak);
+                rate(xStats.ulLines, ulLines, xElapsed, _xRates.ulRXLines, _xRates.ulRXLinesPeak);
+            }
+
+
+            /**
+             * Transmit rates, by base class so a \ref cUART (both bases have getStats) resolves
+             *
+             * \param[in] pxTX Pointer to transmit instance
+             * \param[in,out] ulBytes Bytes at last report
+             * \param[in,out] ulLines Lines at last report
+             * \param[in] xElapsed Ticks since last report
+             */
+            template <uint16_t N>
+            void rateTX(const cUARTTXEngine<N> *pxTX, uint32_t &ulBytes, uint32_t &ulLines, const TickType_t xElapsed) {
+                typename cUARTTXEngine<N>::tTXStats xStats=pxTX->getStats();
+
+                rate(xStats.ulBytes, ulBytes, xElapsed, _xRates.ulTXBytes, _xRates.ulTXBytesPeak);
+                rate(xStats.ulLines, ulLines, xElapsed, _xRates.ulTXLines, _xRates.ulTXLinesPeak);
+            }
+
+
+            /**
+             * Report task loop.  Sample counters each period, compute rates and notify any listeners
+             */
+            void run() {
+                uint32_t ulRXBytes=0, ulRXLines=0, ulTXBytes=0, ulTXLines=0;
+                TickType_t xLast=xTaskGetTickCount(), xNow;
+
+                for (;;) {
+                    vTaskDelay(_xPeriod);
+
+                    xNow=xTaskGetTickCount();
+                    if (xNow!=xLast) {
+                        if (_pxRX) {
+                            rateRX(_pxRX, ulRXBytes, ulRXLines, xNow-xLast);
+                        }
+                        if (_pxTX) {
+                            rateTX(_pxTX, ulTXBytes, ulTXLines, xNow-xLast);
+                        }
+                        xLast=xNow;
+
+                        notify();
+                    }
+                }
+            }
+
+        protected:
+            RX*                 _pxRX;
+            TX*                 _pxTX;
+            TickType_t          _xPeriod;           ///< Report period (ticks)
+            tLinkRates          _xRates;
+    }; // class cUARTReporter
 } // namespace nFRTOSPeripheral
 
 #endif // frtosperipheral_h
@@ -9,9 +9,14 @@
 #ifndef frtosgcpp_h
 #define frtosgcpp_h
 
+#include "codec.h"
+#include "compress.h"
+#include "dlog.h"
+#include "framing.h"
 #include "frtos.h"
 #include "frtos_ext.h"
 #include "frtos_peripheral.h"
+#include "matcher.h"
 #include "pattern.h"
 #include "string_helper.h"
 #include "support.h"
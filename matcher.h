@@ -0,0 +1,109 @@
+/**
+ * \file
+ * Part of the text handling classes, streaming multi-pattern matcher (Aho-Corasick) with tables held in flash
+ * PROJECT          : FRTOS GCPP
+ * TARGET SYSTEM    : Arduino, Maple Mini
+ */
+
+#ifndef matcher_h
+#define matcher_h
+
+namespace nText {
+    /**
+     * A class matching many patterns at once as bytes arrive, Aho-Corasick automaton.  Cost per byte is independent of pattern count.
+     * Tables are generated at build time by tools/acgen.py into a header of PROGMEM arrays, up to 32 patterns each given a bit
+     * in the match mask
+     */
+    class cMatcher {
+        public:
+            /**
+             * Automaton tables, all arrays in flash (PROGMEM).  State 0 is the root
+             */
+            typedef struct {
+                const uint16_t      *pusEdgeFirst;      ///< Per state first edge index, states+1 entries so edges of s are [s, s+1)
+                const uint8_t       *pucEdgeByte;       ///< Per edge byte, sorted within a state
+                const uint16_t      *pusEdgeNext;       ///< Per edge next state
+                const uint16_t      *pusFail;           ///< Per state failure link
+                const uint32_t      *pulMatch;          ///< Per state pattern mask, including those of failure links
+            }tTable;
+
+
+            /**
+             * Constructor.  Make stable instance
+             *
+             * \param[in] xTable Reference to generated tables, must outlive this instance
+             */
+            cMatcher(const tTable &xTable) : _xTable(xTable) { }
+
+
+            /**
+             * Advance automaton by one byte
+             *
+             * \param[in] usState Current state, 0 at start of text
+             * \param[in] ucByte Byte
+             * \return Next state, use with \ref getMatches
+             */
+            uint16_t step(uint16_t usState, const uint8_t ucByte) const {
+                uint16_t usEdge, usLast;
+
+                for(;;) {
+                    usEdge=pgm_read_word(&_xTable.pusEdgeFirst[usState]);
+                    usLast=pgm_read_word(&_xTable.pusEdgeFirst[usState+1]);
+
+                    // edges are sorted so stop once past byte
+                    for(;usEdge<usLast;usEdge++) {
+                        uint8_t ucEdgeByte=pgm_read_byte(&_xTable.pucEdgeByte[usEdge]);
+
+                        if (ucEdgeByte==ucByte) {
+                            return pgm_read_word(&_xTable.pusEdgeNext[usEdge]);
+                        }
+                        if (ucEdgeByte>ucByte) {
+                            break;
+                        }
+                    }
+
+                    if (!usState) {
+                        return 0;
+                    }
+                    usState=pgm_read_word(&_xTable.pusFail[usState]);
+                }
+            }
+
+
+            /**
+             * Get patterns matched ending at state
+             *
+             * \param[in] usState State from \ref step
+             * \return Pattern mask, bit n set for pattern ID n
+             */
+            uint32_t getMatches(const uint16_t usState) const {
+                return pgm_read_dword(&_xTable.pulMatch[usState]);
+            }
+
+
+            /**
+             * Match whole buffer
+             *
+             * \param[in] pucData Pointer to data
+             * \param[in] usLength Data length (bytes)
+             * \return Pattern mask of all matches
+             */
+            uint32_t match(const uint8_t *pucData, const uint16_t usLength) const {
+                uint32_t ulMatches=0;
+                uint16_t usI, usState=0;
+
+                for(usI=0;usI<usLength;usI++) {
+                    usState=step(usState, pucData[usI]);
+                    ulMatches|=getMatches(usState);
+                }
+
+                return ulMatches;
+            }
+
+        protected:
+            const tTable&       _xTable;
+    }; // class cMatcher
+
+} // namespace nText
+
+#endif // matcher_h
@@ -10,6 +10,16 @@
 #define stringhelper_h
 
 namespace nText {
+    /**
+     * Number parse result, \ref cStringHelper::toUInt32 and friends
+     */
+    typedef enum {
+        ePARSE_OK=0,            ///< Value parsed
+        ePARSE_EMPTY,           ///< No digits
+        ePARSE_OVERFLOW         ///< Value out of range, digits consumed and value saturated
+    }ePARSE;
+
+
     /**
      * A helper class for strings (character arrays).  sprintf(...) in maple builds adds 20% to builds and becomes unstable, hence these short helpers just for arduino builds
      */
@@ -52,19 +62,28 @@ namespace nText {
              */
             static char *fromInt(char *pscStr, int32_t n, const uint8_t ucBase) {
                 static char _scASCII[]={ '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f' };
-                int32_t i, sign;
+                uint32_t u;
+                int32_t i;
 
-                // Record sign
-                if ((sign = n) < 0) {
-                    n = -n;        // abs(n)
+                // radix with fast path?
+                if (10==ucBase) {
+                    fromInt32<10>(pscStr, n);
+                    return pscStr;
+                }
+                if (16==ucBase) {
+                    fromInt32<16>(pscStr, n);
+                    return pscStr;
                 }
 
+                // abs(n), unsigned so INT32_MIN is fine
+                u = (n < 0) ? 0u-static_cast<uint32_t>(n) : static_cast<uint32_t>(n);
+
                 i = 0;
                 do {
                     // Generate digits in reverse order
-                    pscStr[i++] = _scASCII[(n % ucBase) & 15];   // Get next digit
-                }while ((n /= ucBase) > 0);    // Delete it
-                if (sign < 0) {
+                    pscStr[i++] = _scASCII[(u % ucBase) & 15];   // Get next digit
+                }while ((u /= ucBase) > 0);    // Delete it
+                if (n < 0) {
                     pscStr[i++] = '-';
                 }
                 pscStr[i] = '\0';    // Null terminator
@@ -74,60 +93,773 @@ namespace nText {
 
 
             /**
-             * String from float (takes a double so slightly misleading)
-             * source: printFloat for Arduno Maple Mini in core/maple/print.cpp
-             * Unfortunately its a private method and within a class that would be bloated for my purposes here, hence is a refactored copy
+             * String from unsigned 32 bit integer, written right to left in place using a digit pair table so there is no reverse
+             * pass.  Hex digits are lower case
+             *
+             * \tparam R Radix, 10 or 16
+             * \param[out] pscStr String pointer, at least 11 characters
+             * \param[in] ul Integer
+             * \return Length (characters), excluding NULL terminator
+             */
+            template <uint8_t R = 10>
+            static uint8_t fromUInt32(char *pscStr, uint32_t ul) {
+                static_assert(10==R || 16==R, "radix 10 or 16");
+                uint8_t ucLength=digits<R>(ul);
+                char *psc=&pscStr[ucLength];
+
+                *psc='\0';
+                if (16==R) {
+                    do {
+                        *--psc=pgm_read_byte(&hexDigits()[ul&15]);
+                        ul>>=4;
+                    }while(ul);
+                }else {
+                    while(ul>=100) {
+                        uint8_t ucPair=static_cast<uint8_t>(ul%100)<<1;
+
+                        ul/=100;
+                        *--psc=pgm_read_byte(&digitPairs()[ucPair+1]);
+                        *--psc=pgm_read_byte(&digitPairs()[ucPair]);
+                    }
+                    if (ul>=10) {
+                        *--psc=pgm_read_byte(&digitPairs()[(ul<<1)+1]);
+                        *--psc=pgm_read_byte(&digitPairs()[ul<<1]);
+                    }else {
+                        *--psc='0'+static_cast<char>(ul);
+                    }
+                }
+
+                return ucLength;
+            } // fromUInt32(...)
+
+
+            /**
+             * String from signed 32 bit integer, full range.  Negative values are '-' and magnitude, also for hex
+             *
+             * \tparam R Radix, 10 or 16
+             * \param[out] pscStr String pointer, at least 12 characters
+             * \param[in] l Integer
+             * \return Length (characters), excluding NULL terminator
+             */
+            template <uint8_t R = 10>
+            static uint8_t fromInt32(char *pscStr, const int32_t l) {
+                if (l<0) {
+                    *pscStr='-';
+                    return 1+fromUInt32<R>(&pscStr[1], 0u-static_cast<uint32_t>(l));
+                }
+
+                return fromUInt32<R>(pscStr, static_cast<uint32_t>(l));
+            } // fromInt32(...)
+
+
+            /**
+             * String from unsigned 64 bit integer.  Radix 10 splits into 8 digit parts so at most two 64 bit divisions are needed
+             *
+             * \tparam R Radix, 10 or 16
+             * \param[out] pscStr String pointer, at least 21 characters
+             * \param[in] ull Integer
+             * \return Length (characters), excluding NULL terminator
+             */
+            template <uint8_t R = 10>
+            static uint8_t fromUInt64(char *pscStr, uint64_t ull) {
+                static_assert(10==R || 16==R, "radix 10 or 16");
+                uint32_t ulPart[2];
+                uint8_t ucLength, ucParts=0;
+
+                if (16==R) {
+                    if (ull>>32) {
+                        ucLength=fromUInt32<16>(pscStr, static_cast<uint32_t>(ull>>32));
+                        padUInt32<16>(&pscStr[ucLength], static_cast<uint32_t>(ull), 8);
+                        return ucLength+8;
+                    }
+                    return fromUInt32<16>(pscStr, static_cast<uint32_t>(ull));
+                }
+
+                while(ull>0xffffffffULL) {
+                    ulPart[ucParts++]=static_cast<uint32_t>(ull%100000000UL);
+                    ull/=100000000UL;
+                }
+                ucLength=fromUInt32<10>(pscStr, static_cast<uint32_t>(ull));
+                while(ucParts) {
+                    padUInt32<10>(&pscStr[ucLength], ulPart[--ucParts], 8);
+                    ucLength+=8;
+                }
+
+                return ucLength;
+            } // fromUInt64(...)
+
+
+            /**
+             * String from signed 64 bit integer, full range.  Negative values are '-' and magnitude, also for hex
+             *
+             * \tparam R Radix, 10 or 16
+             * \param[out] pscStr String pointer, at least 22 characters
+             * \param[in] ll Integer
+             * \return Length (characters), excluding NULL terminator
+             */
+            template <uint8_t R = 10>
+            static uint8_t fromInt64(char *pscStr, const int64_t ll) {
+                if (ll<0) {
+                    *pscStr='-';
+                    return 1+fromUInt64<R>(&pscStr[1], 0u-static_cast<uint64_t>(ll));
+                }
+
+                return fromUInt64<R>(pscStr, static_cast<uint64_t>(ll));
+            } // fromInt64(...)
+
+
+            /**
+             * String from unsigned 32 bit integer, fixed number of digits with leading zeros
+             *
+             * \tparam R Radix, 10 or 16
+             * \param[out] pscStr String pointer, at least ucDigits+1 characters
+             * \param[in] ul Integer, higher digits than ucDigits are lost
+             * \param[in] ucDigits Digits
+             * \return Length (characters), ucDigits
+             */
+            template <uint8_t R = 10>
+            static uint8_t padUInt32(char *pscStr, uint32_t ul, const uint8_t ucDigits) {
+                static_assert(10==R || 16==R, "radix 10 or 16");
+                char *psc=&pscStr[ucDigits];
+                uint8_t ucI=ucDigits;
+
+                *psc='\0';
+                if (16==R) {
+                    while(ucI--) {
+                        *--psc=pgm_read_byte(&hexDigits()[ul&15]);
+                        ul>>=4;
+                    }
+                }else {
+                    for(;ucI>=2;ucI-=2) {
+                        uint8_t ucPair=static_cast<uint8_t>(ul%100)<<1;
+
+                        ul/=100;
+                        *--psc=pgm_read_byte(&digitPairs()[ucPair+1]);
+                        *--psc=pgm_read_byte(&digitPairs()[ucPair]);
+                    }
+                    if (ucI) {
+                        *--psc='0'+static_cast<char>(ul%10);
+                    }
+                }
+
+                return ucDigits;
+            } // padUInt32(...)
+
+
+            /**
+             * Count digits of unsigned 32 bit integer
+             *
+             * \tparam R Radix, 10 or 16
+             * \param[in] ul Integer
+             * \return Digits, at least 1
+             */
+            template <uint8_t R = 10>
+            static uint8_t digits(uint32_t ul) {
+                uint8_t ucDigits=1;
+
+                if (16==R) {
+                    while(ul>>=4) {
+                        ucDigits++;
+                    }
+                }else {
+                    for(uint32_t ulPower=10;ucDigits<10 && ul>=ulPower;ulPower*=10) {
+                        ucDigits++;
+                    }
+                }
+
+                return ucDigits;
+            } // digits(...)
+
+
+            /**
+             * String from float (takes a double so slightly misleading).  Converted once to a scaled integer then formatted in one
+             * pass, no floating point per digit.  Rounds the exact binary value to nearest, ties to even, as printf e.g. 0.015 (stored
+             * just below) to 2 places is "0.01" and 0.125 is "0.12".  "nan", "inf", "-inf" and "ovf" (magnitude 2^32 or more, or
+             * rounding to it) as Arduino print
              *
              * \param[out] pscStr String pointer
-             * \param[in] n Integer
-             * \param[in] digits Number of digits to resolve
-             * \return Character string pointer
+             * \param[in] n Value
+             * \param[in] digits Number of decimal places, at most 9
+             * \return Length (characters), excluding NULL terminator
              */
             static uint8_t fromFloat(char *pscStr, double n, uint8_t digits) {
+                uint32_t ulInt, ulFrac, ulPower;
+                uint64_t ullFrac, ullLow, ullMid;
                 uint8_t ucLength=0;
+                bool bSticky;
 
-                // Ignore dealing with super large values - we know they wont be in our working system
-
-                // Handle negative numbers
+                if (n!=n) {
+                    return copy(pscStr, "nan");
+                }
                 if (n < 0.0) {
                     pscStr[ucLength++]='-';
                     n = -n;
                 }
-                pscStr[ucLength]='\0';
+                if (n>=4294967296.0) {
+                    // inf-inf is nan
+                    return ucLength+copy(&pscStr[ucLength], (n-n==0.0) ? "ovf" : "inf");
+                }
+                if (digits>9) {
+                    digits=9;
+                }
+
+                // fraction is exact as 0.64 fixed point, bits below only when tiny so kept as sticky
+                ulPower=power10(digits);
+                ulInt=static_cast<uint32_t>(n);
+                n=(n-ulInt)*18446744073709551616.0;
+                ullFrac=static_cast<uint64_t>(n);
+                bSticky=(n!=static_cast<double>(ullFrac));
+
+                // fraction scaled by 10^digits, 64x32 bit multiply keeping the remainder to round on
+                ullLow=(ullFrac&0xffffffffULL)*ulPower;
+                ullMid=(ullFrac>>32)*ulPower+(ullLow>>32);
+                ulFrac=static_cast<uint32_t>(ullMid>>32);
+                ullLow=(ullMid<<32) | (ullLow&0xffffffffULL);
+                if (ullLow>0x8000000000000000ULL || (0x8000000000000000ULL==ullLow && (bSticky || ((digits ? ulFrac : ulInt)&1)))) {
+                    ulFrac++;
+                }
+
+                // carry on round up e.g. 1.999 to 2 places is 2.00, overflow when rounded to 2^32
+                if (ulFrac>=ulPower) {
+                    ulFrac-=ulPower;
+                    if (!++ulInt) {
+                        return ucLength+copy(&pscStr[ucLength], "ovf");
+                    }
+                }
+
+                return ucLength+fromParts(&pscStr[ucLength], ulInt, ulFrac, digits);
+            } // fromFloat(...)
+
+
+            /**
+             * String from fixed point scaled integer, value is lValue/10^ucDecimals e.g. 12345 with 2 decimals is "123.45"
+             *
+             * \param[out] pscStr String pointer, at least 13 characters
+             * \param[in] lValue Scaled value
+             * \param[in] ucDecimals Decimal places, at most 9
+             * \return Length (characters), excluding NULL terminator
+             */
+            static uint8_t fromScaled(char *pscStr, const int32_t lValue, uint8_t ucDecimals) {
+                uint32_t ulValue=(lValue<0) ? 0u-static_cast<uint32_t>(lValue) : static_cast<uint32_t>(lValue);
+                uint32_t ulPower;
+                uint8_t ucLength=0;
+
+                if (lValue<0) {
+                    pscStr[ucLength++]='-';
+                }
+                if (ucDecimals>9) {
+                    ucDecimals=9;
+                }
+                ulPower=power10(ucDecimals);
+
+                return ucLength+fromParts(&pscStr[ucLength], ulValue/ulPower, ulValue%ulPower, ucDecimals);
+            } // fromScaled(...)
+
+
+            /**
+             * String from Q format fixed point, value is lValue/2^ucFracBits e.g. Q16.16 has 16 fraction bits.  Fraction is rounded
+             * half up to ucDecimals places
+             *
+             * \param[out] pscStr String pointer, at least 22 characters
+             * \param[in] lValue Q format value
+             * \param[in] ucFracBits Fraction bits, 0 to 31
+             * \param[in] ucDecimals Decimal places, at most 9
+             * \return Length (characters), excluding NULL terminator
+             */
+            static uint8_t fromQ(char *pscStr, const int32_t lValue, const uint8_t ucFracBits, uint8_t ucDecimals) {
+                uint32_t ulValue=(lValue<0) ? 0u-static_cast<uint32_t>(lValue) : static_cast<uint32_t>(lValue);
+                uint32_t ulInt, ulFrac, ulPower;
+                uint8_t ucLength=0;
+
+                if (lValue<0) {
+                    pscStr[ucLength++]='-';
+                }
+                if (ucDecimals>9) {
+                    ucDecimals=9;
+                }
+                ulPower=power10(ucDecimals);
+                ulInt=ucFracBits ? ulValue>>ucFracBits : ulValue;
+                ulFrac=ucFracBits ? ulValue&((1UL<<ucFracBits)-1) : 0;
+                if (ucFracBits) {
+                    // one multiply to decimal, 64 bit as fraction*10^9 needs it
+                    ulFrac=static_cast<uint32_t>((static_cast<uint64_t>(ulFrac)*ulPower+(1UL<<(ucFracBits-1)))>>ucFracBits);
+                }
+                if (ulFrac>=ulPower) {
+                    ulFrac-=ulPower;
+                    ulInt++;
+                }
+
+                return ucLength+fromParts(&pscStr[ucLength], ulInt, ulFrac, ucDecimals);
+            } // fromQ(...)
+
+
+            /**
+             * Parse unsigned decimal from string view, no allocation.  Leading spaces and tabs are skipped, parsing stops at the first
+             * non digit
+             *
+             * \param[in] pscStr Pointer to characters, need not be NULL terminated
+             * \param[in] usLength Characters available
+             * \param[out] ulValue Value
+             * \param[out] usUsed Characters consumed, including skipped spaces, 0 when ePARSE_EMPTY
+             * \return Parse result
+             */
+            static ePARSE toUInt32(const char *pscStr, const uint16_t usLength, uint32_t &ulValue, uint16_t &usUsed) {
+                usUsed=skip(pscStr, usLength, 0);
+
+                return used(digitsTo(pscStr, usLength, usUsed, ulValue, 10), usUsed);
+            } // toUInt32(...)
+
+
+            /**
+             * Parse signed decimal from string view, optional '+' or '-' sign, full range.  \ref toUInt32
+             *
+             * \param[in] pscStr Pointer to characters, need not be NULL terminated
+             * \param[in] usLength Characters available
+             * \param[out] lValue Value
+             * \param[out] usUsed Characters consumed, including skipped spaces, 0 when ePARSE_EMPTY
+             * \return Parse result
+             */
+            static ePARSE toInt32(const char *pscStr, const uint16_t usLength, int32_t &lValue, uint16_t &usUsed) {
+                bool bNegative=false;
+                uint32_t ulValue;
+                ePARSE eResult;
+
+                usUsed=sign(pscStr, usLength, skip(pscStr, usLength, 0), bNegative);
+                eResult=used(digitsTo(pscStr, usLength, usUsed, ulValue, 10), usUsed);
+
+                return signedTo(eResult, ulValue, bNegative, lValue);
+            } // toInt32(...)
+
+
+            /**
+             * Parse hex from string view, optional "0x" or "0X" prefix, either case digits.  \ref toUInt32
+             *
+             * \param[in] pscStr Pointer to characters, need not be NULL terminated
+             * \param[in] usLength Characters available
+             * \param[out] ulValue Value
+             * \param[out] usUsed Characters consumed, including skipped spaces, 0 when ePARSE_EMPTY
+             * \return Parse result
+             */
+            static ePARSE toHex32(const char *pscStr, const uint16_t usLength, uint32_t &ulValue, uint16_t &usUsed) {
+                usUsed=skip(pscStr, usLength, 0);
+                if (usUsed+2<usLength && '0'==pscStr[usUsed] && ('x'==pscStr[usUsed+1] || 'X'==pscStr[usUsed+1]) &&
+                                                                                    hexValue(pscStr[usUsed+2])>=0) {
+                    usUsed+=2;
+                }
+
+                return used(digitsTo(pscStr, usLength, usUsed, ulValue, 16), usUsed);
+            } // toHex32(...)
+
+
+            /**
+             * Parse fixed point decimal from string view into scaled integer, e.g. "-12.3" with 2 decimals is -1230.  Fraction digits
+             * beyond ucDecimals are consumed and rounded half away from zero.  \ref toInt32
+             *
+             * \param[in] pscStr Pointer to characters, need not be NULL terminated
+             * \param[in] usLength Characters available
+             * \param[in] ucDecimals Decimal places of result, at most 9
+             * \param[out] lValue Value scaled by 10^ucDecimals
+             * \param[out] usUsed Characters consumed, including skipped spaces, 0 when ePARSE_EMPTY
+             * \return Parse result
+             */
+            static ePARSE toScaled(const char *pscStr, const uint16_t usLength, const uint8_t ucDecimals, int32_t &lValue,
+                                                                                                                uint16_t &usUsed) {
+                bool bNegative=false, bDigits=false, bOverflow=false;
+                uint32_t ulValue=0;
+                uint8_t ucI=0;
+                int8_t scDigit;
+
+                usUsed=sign(pscStr, usLength, skip(pscStr, usLength, 0), bNegative);
+
+                // integer part
+                while(usUsed<usLength && (scDigit=digitValue(pscStr[usUsed], 10))>=0) {
+                    bOverflow|=!accumulate(ulValue, scDigit, 10);
+                    bDigits=true;
+                    usUsed++;
+                }
+
+                // fraction, digits beyond ucDecimals round
+                if (usUsed+1<usLength && '.'==pscStr[usUsed] && digitValue(pscStr[usUsed+1], 10)>=0) {
+                    usUsed++;
+                    for(;usUsed<usLength && (scDigit=digitValue(pscStr[usUsed], 10))>=0;usUsed++,ucI++) {
+                        if (ucI<ucDecimals) {
+                            bOverflow|=!accumulate(ulValue, scDigit, 10);
+                        }else if (ucI==ucDecimals && scDigit>=5) {
+                            bOverflow|=!accumulate(ulValue, 1, 1);
+                        }
+                    }
+                    bDigits=true;
+                }
+                if (!bDigits) {
+                    lValue=0;
+                    return used(ePARSE_EMPTY, usUsed);
+                }
+                for(;ucI<ucDecimals;ucI++) {
+                    bOverflow|=!accumulate(ulValue, 0, 10);
+                }
+
+                return signedTo(bOverflow ? ePARSE_OVERFLOW : ePARSE_OK, ulValue, bNegative, lValue);
+            } // toScaled(...)
+
+
+            /**
+             * Parse float from string view, decimal with optional fraction and exponent e.g. "-1.5e3".  Up to 9 significant digits
+             * are used, scaled by a power of 10 built by repeated squaring (after one or two divides by 1e32 below 1e-32).  Where double
+             * is 64 bit the result is within 1 ULP of strtof, mostly identical.  Where double is float, e.g. AVR, within 3 ULP, mostly 1.  \ref toInt32
+             *
+             * \param[in] pscStr Pointer to characters, need not be NULL terminated
+             * \param[in] usLength Characters available
+             * \param[out] fValue Value
+             * \param[out] usUsed Characters consumed, including skipped spaces, 0 when ePARSE_EMPTY
+             * \return Parse result, ePARSE_OVERFLOW when out of float range
+             */
+            static ePARSE toFloat(const char *pscStr, const uint16_t usLength, float &fValue, uint16_t &usUsed) {
+                bool bNegative=false, bDigits=false, bExpNegative=false;
+                uint32_t ulMantissa=0, ulExp=0;
+                uint8_t ucSignificant=0;
+                double dValue;
+                int16_t sExp=0;
+                int8_t scDigit;
+                uint16_t usI;
+
+                usUsed=sign(pscStr, usLength, skip(pscStr, usLength, 0), bNegative);
+
+                // mantissa, integer then fraction
+                for(;usUsed<usLength && (scDigit=digitValue(pscStr[usUsed], 10))>=0;usUsed++) {
+                    if (ucSignificant<9) {
+                        ulMantissa=ulMantissa*10+scDigit;
+                        ucSignificant+=(ulMantissa ? 1 : 0);
+                    }else {
+                        sExp++;
+                    }
+                    bDigits=true;
+                }
+                if (usUsed<usLength && '.'==pscStr[usUsed]) {
+                    for(usUsed++;usUsed<usLength && (scDigit=digitValue(pscStr[usUsed], 10))>=0;usUsed++) {
+                        if (ucSignificant<9) {
+                            ulMantissa=ulMantissa*10+scDigit;
+                            ucSignificant+=(ulMantissa ? 1 : 0);
+                            sExp--;
+                        }
+                        bDigits=true;
+                    }
+                }
+                if (!bDigits) {
+                    fValue=0;
+                    return used(ePARSE_EMPTY, usUsed);
+                }
+
+                // exponent, only when digits follow
+                if (usUsed+1<usLength && ('e'==pscStr[usUsed] || 'E'==pscStr[usUsed])) {
+                    usI=sign(pscStr, usLength, usUsed+1, bExpNegative);
+                    if (usI<usLength && digitValue(pscStr[usI], 10)>=0) {
+                        usUsed=usI;
+                        if (ePARSE_OK!=digitsTo(pscStr, usLength, usUsed, ulExp, 10) || ulExp>1000) {
+                            ulExp=1000;
+                        }
+                        sExp+=bExpNegative ? -static_cast<int16_t>(ulExp) : static_cast<int16_t>(ulExp);
+                    }
+                }
+
+                // zero needs no scaling, 0*inf is nan where double is float.  Clamp beyond float range either way, divide by
+                // powers as their reciprocals are inexact
+                if (!ulMantissa) {
+                    sExp=0;
+                }else if (sExp>63) {
+                    sExp=63;
+                }else if (sExp<-95) {
+                    sExp=-95;
+                }
+                dValue=static_cast<double>(ulMantissa);
+                if (sExp<-63) {
+                    dValue/=1e32;
+                    sExp+=32;
+                }
+                if (sExp<-32) {
+                    dValue/=1e32;
+                    sExp+=32;
+                }
+                if (sExp<0) {
+                    dValue/=scale10(static_cast<uint8_t>(-sExp));
+                }else {
+                    dValue*=scale10(static_cast<uint8_t>(sExp));
+                }
+                fValue=static_cast<float>(dValue);
+                if (bNegative) {
+                    fValue=-fValue;
+                }
+
+                return (fValue-fValue==0) ? ePARSE_OK : ePARSE_OVERFLOW;
+            } // toFloat(...)
+
+
+            /**
+             * Get digit value
+             *
+             * \param[in] sc Character
+             * \param[in] ucRadix Radix, 10 or 16
+             * \return Value or -1 when not a digit
+             */
+            static int8_t digitValue(const char sc, const uint8_t ucRadix) {
+                if (sc>='0' && sc<='9') {
+                    return sc-'0';
+                }
+
+                return (16==ucRadix) ? hexValue(sc) : -1;
+            }
+
+
+            /**
+             * Get hex digit value, either case
+             *
+             * \param[in] sc Character
+             * \return Value or -1 when not a hex digit
+             */
+            static int8_t hexValue(const char sc) {
+                if (sc>='0' && sc<='9') {
+                    return sc-'0';
+                }
+                if ((sc|0x20)>='a' && (sc|0x20)<='f') {
+                    return (sc|0x20)-'a'+10;
+                }
+
+                return -1;
+            }
+
+
+            /**
+             * Hex digits in flash, lower case
+             *
+             * \return Pointer to table (PROGMEM)
+             */
+            static const char *hexDigits() {
+                static const char _scHex[] PROGMEM = "0123456789abcdef";
+
+                return _scHex;
+            }
+
+        protected:
+            /**
+             * Skip spaces and tabs
+             *
+             * \param[in] pscStr Pointer to characters
+             * \param[in] usLength Characters available
+             * \param[in] usI Index to start from
+             * \return Index after spaces
+             */
+            static uint16_t skip(const char *pscStr, const uint16_t usLength, uint16_t usI) {
+                while(usI<usLength && (' '==pscStr[usI] || '\t'==pscStr[usI])) {
+                    usI++;
+                }
+
+                return usI;
+            }
+
+
+            /**
+             * Consume optional sign
+             *
+             * \param[in] pscStr Pointer to characters
+             * \param[in] usLength Characters available
+             * \param[in] usI Index of possible sign
+             * \param[out] bNegative Negative state
+             * \return Index after sign
+             */
+            static uint16_t sign(const char *pscStr, const uint16_t usLength, uint16_t usI, bool &bNegative) {
+                bNegative=false;
+                if (usI<usLength && ('-'==pscStr[usI] || '+'==pscStr[usI])) {
+                    bNegative=('-'==pscStr[usI++]);
+                }
+
+                return usI;
+            }
+
+
+            /**
+             * Accumulate digit, ulValue=ulValue*ucRadix+ucDigit with overflow detection
+             *
+             * \param[in,out] ulValue Value, saturated on overflow
+             * \param[in] ucDigit Digit
+             * \param[in] ucRadix Radix, 1 adds ucDigit only
+             * \return Success, false on overflow
+             */
+            static bool accumulate(uint32_t &ulValue, const uint8_t ucDigit, const uint8_t ucRadix) {
+                if (ulValue>(0xffffffffUL-ucDigit)/ucRadix) {
+                    ulValue=0xffffffffUL;
+                    return false;
+                }
+                ulValue=ulValue*ucRadix+ucDigit;
+
+                return true;
+            }
+
+
+            /**
+             * Consume digits into unsigned value
+             *
+             * \param[in] pscStr Pointer to characters
+             * \param[in] usLength Characters available
+             * \param[in,out] usI Index, updated past digits
+             * \param[out] ulValue Value, saturated on overflow
+             * \param[in] ucRadix Radix, 10 or 16
+             * \return Parse result
+             */
+            static ePARSE digitsTo(const char *pscStr, const uint16_t usLength, uint16_t &usI, uint32_t &ulValue,
+                                                                                                        const uint8_t ucRadix) {
+                uint16_t usStart=usI;
+                bool bOverflow=false;
+                int8_t scDigit;
 
-                // Simplistic rounding strategy so that e.g. print(1.999, 2)
-                // prints as "2.00"
-                double rounding = 0.5;
-                for (uint8_t i = 0; i < digits; i++) {
-                    rounding /= 10.0;
+                ulValue=0;
+                for(;usI<usLength && (scDigit=digitValue(pscStr[usI], ucRadix))>=0;usI++) {
+                    bOverflow|=!accumulate(ulValue, scDigit, ucRadix);
                 }
-                n += rounding;
+                if (usI==usStart) {
+                    return ePARSE_EMPTY;
+                }
+
+                return bOverflow ? ePARSE_OVERFLOW : ePARSE_OK;
+            }
 
-                // Extract the integer part of the number and print it
-                uint32_t int_part = (uint32_t)n;
-                double remainder = n - int_part;
-                cStringHelper::fromInt(&pscStr[ucLength], int_part, 10);
-                ucLength=strlen(pscStr);
 
-                // Print the decimal point, but only if there are digits beyond
-                if (digits > 0) {
+            /**
+             * Apply sign to magnitude with range check
+             *
+             * \param[in] eResult Magnitude parse result
+             * \param[in] ulValue Magnitude
+             * \param[in] bNegative Negative state
+             * \param[out] lValue Value, saturated on overflow
+             * \return Parse result
+             */
+            static ePARSE signedTo(ePARSE eResult, const uint32_t ulValue, const bool bNegative, int32_t &lValue) {
+                if (ePARSE_EMPTY==eResult) {
+                    lValue=0;
+                    return eResult;
+                }
+                if (ulValue>(bNegative ? 0x80000000UL : 0x7fffffffUL)) {
+                    eResult=ePARSE_OVERFLOW;
+                }
+                if (ePARSE_OVERFLOW==eResult) {
+                    lValue=bNegative ? INT32_MIN : INT32_MAX;
+                }else {
+                    lValue=bNegative ? static_cast<int32_t>(0u-ulValue) : static_cast<int32_t>(ulValue);
+                }
+
+                return eResult;
+            }
+
+
+            /**
+             * String from integer and fraction parts, "int.frac" with fraction zero padded
+             *
+             * \param[out] pscStr String pointer
+             * \param[in] ulInt Integer part
+             * \param[in] ulFrac Fraction part scaled by 10^ucDecimals
+             * \param[in] ucDecimals Decimal places, 0 for none and no point
+             * \return Length (characters), excluding NULL terminator
+             */
+            static uint8_t fromParts(char *pscStr, const uint32_t ulInt, const uint32_t ulFrac, const uint8_t ucDecimals) {
+                uint8_t ucLength=fromUInt32<10>(pscStr, ulInt);
+
+                if (ucDecimals) {
                     pscStr[ucLength++]='.';
-                    pscStr[ucLength]='\0';
+                    ucLength+=padUInt32<10>(&pscStr[ucLength], ulFrac, ucDecimals);
+                }
+
+                return ucLength;
+            }
+
+
+            /**
+             * Power of 10 as double by squaring, 10^1 to 10^16 squares are exact in 64 bit double so few roundings
+             *
+             * \param[in] ucExponent Exponent, 0 to 63
+             * \return 10^ucExponent, infinite where double is float and beyond its range
+             */
+            static double scale10(uint8_t ucExponent) {
+                double dPower=1.0, dSquare=10.0;
+
+                for(;ucExponent;ucExponent>>=1) {
+                    if (ucExponent&1) {
+                        dPower*=dSquare;
+                    }
+                    dSquare*=dSquare;
+                }
+
+                return dPower;
+            }
+
+
+            /**
+             * Empty parse consumes nothing
+             *
+             * \param[in] eResult Parse result
+             * \param[in,out] usUsed Characters consumed, cleared when eResult is ePARSE_EMPTY
+             * \return eResult
+             */
+            static ePARSE used(const ePARSE eResult, uint16_t &usUsed) {
+                if (ePARSE_EMPTY==eResult) {
+                    usUsed=0;
                 }
 
-                // Extract digits from the remainder one at a time
-                while(digits-- > 0) {
-                    remainder *= 10.0;
-                    uint32_t to_print = (uint32_t)remainder;
+                return eResult;
+            }
+
 
-                    cStringHelper::fromInt(&pscStr[ucLength], to_print, 10);
-                    ucLength=strlen(pscStr);
+            /**
+             * Power of 10
+             *
+             * \param[in] ucExponent Exponent, 0 to 9
+             * \return 10^ucExponent
+             */
+            static uint32_t power10(uint8_t ucExponent) {
+                uint32_t ulPower=1;
 
-                    remainder -= to_print;
+                while(ucExponent--) {
+                    ulPower*=10;
                 }
 
+                return ulPower;
+            }
+
+
+            /**
+             * Copy short string including NULL terminator
+             *
+             * \param[out] pscStr String pointer
+             * \param[in] pscFrom Source string pointer
+             * \return Length (characters), excluding NULL terminator
+             */
+            static uint8_t copy(char *pscStr, const char *pscFrom) {
+                uint8_t ucLength=static_cast<uint8_t>(strlen(pscFrom));
+
+                memcpy(pscStr, pscFrom, ucLength+1);
+
                 return ucLength;
-            } // fromFloat(...)
+            }
+
+
+            /**
+             * Decimal digit pairs "00" to "99" in flash
+             *
+             * \return Pointer to table (PROGMEM)
+             */
+            static const char *digitPairs() {
+                static const char _scPairs[] PROGMEM =
+                    "00010203040506070809"
+                    "10111213141516171819"
+                    "20212223242526272829"
+                    "30313233343536373839"
+                    "40414243444546474849"
+                    "50515253545556575859"
+                    "60616263646566676869"
+                    "70717273747576777879"
+                    "80818283848586878889"
+                    "90919293949596979899";
+
+                return _scPairs;
+            }
+
     }; // cStringHelper
 
 } // namespace nText
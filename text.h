@@ -9,6 +9,9 @@
 #ifndef text_h
 #define text_h
 
+#include "framing.h"
+#include "matcher.h"
+
 namespace nText {
     /**
      * A class to represent a text line string
@@ -93,28 +96,163 @@ namespace nText {
                 return _ucLength;
             }
 
+
+            /**
+             * Get pointer to line buffer for writing in place, N+1 characters.  Follow with \ref setLineLength
+             *
+             * \return Pointer to line buffer
+             */
+            char *getBuffer() {
+                return _scLine;
+            }
+
+
+            /**
+             * Set line length after writing in place via \ref getBuffer, installs NULL terminator
+             *
+             * \param[in] ucLength Line length (characters), truncated to N
+             */
+            void setLineLength(const uint8_t ucLength) {
+                _ucLength=(ucLength>N) ? N : ucLength;
+                _scLine[_ucLength]=0x00;
+            }
+
         protected:
             char                _scLine[N+1];
             uint8_t             _ucLength;
     }; // class cTextLine
 
 
+    /**
+     * Maximum characters read in one go by \ref cTexter::characterReadMany before line parsing.  Define your own should you wish to change
+     */
+#if !defined(CTEXTER_RX_CHUNK_MAX)
+    #define CTEXTER_RX_CHUNK_MAX     16
+#endif
+
+
+    /**
+     * Line overflow policies, what \ref cTexter does when a line (frame) is longer than its buffer
+     */
+    typedef enum {
+        eOVERFLOW_DISCARD   = 0,        ///< Discard line up to and including next terminator
+        eOVERFLOW_TRUNCATE,             ///< Keep start of line, drop the rest up to next terminator then deliver it
+        eOVERFLOW_PARTIAL,              ///< Deliver line in buffer sized chunks
+    }eOVERFLOW;
+
+
+    /**
+     * Line state flags, \ref cTexter::getLineFlags
+     */
+    typedef enum {
+        eLINE_COMPLETE      = 0x00,     ///< Line complete
+        eLINE_PARTIAL       = 0x01,     ///< Line is a chunk, more of it follows (\ref eOVERFLOW_PARTIAL)
+        eLINE_TRUNCATED     = 0x02,     ///< Line end was dropped (\ref eOVERFLOW_TRUNCATE)
+    }eLINE;
+
+
     /**
      * Class to aid device specific text line i/o
      *
      * \tparam N Text line length (characters, including NULL)
+     * \tparam F Framing engine class finding lines in received characters, see \ref eFRAME.  Default \ref cFramerCRLF
      */
-    template <uint16_t N>
+    template <uint16_t N, class F = cFramerCRLF>
     class cTexter : public cTextLine<N> {
         public:
-            cTexter() : cTextLine<N>() { }
+            /**
+             * Line reception statistics, \ref getLineStats
+             */
+            typedef struct {
+                uint32_t        ulOverflows;        ///< Lines longer than buffer
+                uint32_t        ulDiscarded;        ///< Bytes discarded by overflow policy or framing errors
+                uint16_t        usLengthMax;        ///< Maximum line length seen including any overflow (bytes, saturates)
+            }tLineStats;
+
+
+            cTexter() : cTextLine<N>(), _ucChunkHead(0), _ucChunkTail(0), _usRXLength(0), _usRXTotal(0), _eOverflow(eOVERFLOW_DISCARD),
+                        _bOverflow(false), _ucLineFlags(eLINE_COMPLETE), _ucPendingAction(eFRAME_NONE), _ucPending(0),
+                        _pxMatcher(NULL), _usMatchState(0), _ulMatching(0), _ulLineMatches(0) {
+                memset(&_xLineStats, 0, sizeof(_xLineStats));
+            }
+
+
+            /**
+             * Get framing engine, allows configuration
+             *
+             * \return Framing engine reference
+             */
+            F &getFramer() {
+                return _xFramer;
+            }
+
+
+            /**
+             * Set line overflow policy
+             *
+             * \param[in] eOverflow Overflow policy, default \ref eOVERFLOW_DISCARD
+             */
+            void setOverflowPolicy(const eOVERFLOW eOverflow) {
+                _eOverflow=eOverflow;
+            }
+
+
+            /**
+             * Get state flags of last line read.  \ref nFRTOSPeripheral::cUARTRX keeps them per line buffer
+             *
+             * \return \ref eLINE flags
+             */
+            uint8_t getLineFlags() const {
+                return _ucLineFlags;
+            }
+
+
+            /**
+             * Set pattern matcher run on line bytes as they arrive, \ref getLineMatches
+             *
+             * \param[in] pxMatcher Pointer to matcher, NULL for none
+             */
+            void setMatcher(const cMatcher *pxMatcher) {
+                _pxMatcher=pxMatcher;
+                _usMatchState=0;
+                _ulMatching=0;
+            }
+
+
+            /**
+             * Get patterns matched in last line read, see \ref setMatcher.  For \ref eLINE_PARTIAL lines includes earlier chunks.
+             * \ref nFRTOSPeripheral::cUARTRX keeps them per line buffer
+             *
+             * \return Pattern mask, bit n set for pattern ID n
+             */
+            uint32_t getLineMatches() const {
+                return _ulLineMatches;
+            }
+
+
+            /**
+             * Get line reception statistics, use to size N
+             *
+             * \return Copy of statistics
+             */
+            tLineStats getLineStats() const {
+                return _xLineStats;
+            }
+
+
+            /**
+             * Reset line reception statistics
+             */
+            void resetLineStats() {
+                memset(&_xLineStats, 0, sizeof(_xLineStats));
+            }
 
         protected:
 
             /**
              * Character read delay
              */
-            virtual void characterReadDelay() const = 0;
+            virtual void characterReadDelay() = 0;
 
 
             /**
@@ -125,6 +263,35 @@ namespace nText {
             virtual bool characterRead(char *pscChar) = 0;
 
 
+            /**
+             * Characters read, all those available now up to usMax without waiting.  Default reads via \ref characterRead, override when
+             * device can do better
+             *
+             * \param[out] pscBuffer Pointer to character receive buffer
+             * \param[in] usMax Maximum characters to read
+             * \return Characters read into pscBuffer
+             */
+            virtual uint16_t characterReadMany(char *pscBuffer, const uint16_t usMax) {
+                uint16_t usCount=0;
+
+                while(usCount<usMax && characterRead(&pscBuffer[usCount])) {
+                    usCount++;
+                }
+
+                return usCount;
+            }
+
+
+            /**
+             * Characters read but not yet framed, e.g. the start of the next line read with the end of the last
+             *
+             * \return Staged characters state
+             */
+            bool isStaged() const {
+                return _ucPendingAction || _ucChunkHead<_ucChunkTail;
+            }
+
+
             /**
              * Character write
              */
@@ -132,37 +299,157 @@ namespace nText {
 
 
             /**
-             * Blocking read line as character string from given \ref cTexter instance
+             * Read line (frame) as character string from given \ref cTexter instance, non-blocking.  Drains all characters available
+             * before returning, line state is held between calls.  Binary frames may contain NULL characters, use \ref getLineLength
              *
-             * \note Assumes a line string is terminated by "\r\n" character combo
              * \param pxThis Instance of CTexter (data source)
-             * \param pscData Data buffer to store characters
+             * \param xLine Line to store characters in, keep the same one until complete
+             * \return Line complete state
+             * \retval true Line complete in xLine
+             * \retval false No more characters available, line incomplete
              */
-            static void blockingReadLine(cTexter<N> *pxThis, char *pscData) {
-                char    scLast=0,scCurrent;
-                uint8_t    ucLength=0;
+            static bool readLine(cTexter<N, F> *pxThis, cTextLine<N> &xLine) {
+                uint8_t ucOut, ucAction;
+
+                // byte held over from delivering a chunk?
+                if (pxThis->_ucPendingAction) {
+                    ucAction=pxThis->_ucPendingAction;
+                    pxThis->_ucPendingAction=eFRAME_NONE;
+                    if (frameAction(pxThis, xLine, ucAction, pxThis->_ucPending)) {
+                        return true;
+                    }
+                }
 
                 while(1) {
-                    if (pxThis->characterRead(&scCurrent)) {
-    
-                        if (ucLength>=N) {
-                            ucLength=0;
+                    // staged characters used up?  read as many as are available
+                    if (pxThis->_ucChunkHead>=pxThis->_ucChunkTail) {
+                        pxThis->_ucChunkHead=0;
+                        pxThis->_ucChunkTail=static_cast<uint8_t>(pxThis->characterReadMany(pxThis->_scChunk, CTEXTER_RX_CHUNK_MAX));
+                        if (!pxThis->_ucChunkTail) {
+                            // nothing available, time based framing may close line
+                            return frameAction(pxThis, xLine, pxThis->_xFramer.idle(), 0);
                         }
-                        pscData[ucLength++]=scCurrent;
+                        pxThis->_xFramer.received(pxThis->_ucChunkTail);
+                    }
 
-                        if (scCurrent=='\n' && scLast=='\r') {
+                    ucAction=pxThis->_xFramer.feed(static_cast<uint8_t>(pxThis->_scChunk[pxThis->_ucChunkHead]), ucOut);
+                    if (!(ucAction & eFRAME_HOLD)) {
+                        pxThis->_ucChunkHead++;
+                    }
+
+                    if ((ucAction & eFRAME_STORE) && pxThis->_pxMatcher) {
+                        pxThis->_usMatchState=pxThis->_pxMatcher->step(pxThis->_usMatchState, ucOut);
+                        pxThis->_ulMatching|=pxThis->_pxMatcher->getMatches(pxThis->_usMatchState);
+                    }
+
+                    if (frameAction(pxThis, xLine, ucAction, ucOut)) {
+                        return true;
+                    }
+                }
+            }
 
-                            if (ucLength>1) {
-                                pscData[ucLength]=0;    // install null terminator and we're done...
 
-                                pxThis->_ucLength=ucLength;
-                                break;
-                            }
+            /**
+             * Apply framing engine action to line being read, deals with overflow policy
+             *
+             * \param pxThis Instance of CTexter (data source)
+             * \param xLine Line to store characters in
+             * \param ucAction \ref eFRAME flags from framing engine
+             * \param ucOut Byte to store
+             * \return Line complete state
+             */
+            static bool frameAction(cTexter<N, F> *pxThis, cTextLine<N> &xLine, const uint8_t ucAction, const uint8_t ucOut) {
+                if (ucAction & eFRAME_ERROR) {
+                    pxThis->_xLineStats.ulDiscarded+=pxThis->_usRXLength;
+                    pxThis->_usRXLength=0;
+                    pxThis->_usRXTotal=0;
+                    pxThis->_bOverflow=false;
+                    pxThis->_usMatchState=0;
+                    pxThis->_ulMatching=0;
+                }
+
+                if (ucAction & eFRAME_STORE) {
+                    if (pxThis->_usRXTotal<0xFFFF) {
+                        pxThis->_usRXTotal++;
+                    }
+
+                    if (pxThis->_bOverflow) {
+                        // truncating or discarding rest of line
+                        pxThis->_xLineStats.ulDiscarded++;
+                    }else if (pxThis->_usRXLength>=N) {
+                        pxThis->_xLineStats.ulOverflows++;
+
+                        if (eOVERFLOW_PARTIAL==pxThis->_eOverflow) {
+                            // deliver what we have, byte (and any end) is held for the next chunk
+                            pxThis->_ucPending=ucOut;
+                            pxThis->_ucPendingAction=ucAction & (eFRAME_STORE | eFRAME_END);
+                            pxThis->_usRXTotal--;
+                            return lineComplete(pxThis, xLine, eLINE_PARTIAL);
+                        }
+
+                        pxThis->_bOverflow=true;
+                        pxThis->_xLineStats.ulDiscarded++;
+                        if (eOVERFLOW_DISCARD==pxThis->_eOverflow) {
+                            pxThis->_xLineStats.ulDiscarded+=pxThis->_usRXLength;
+                            pxThis->_usRXLength=0;
                         }
+                    }else {
+                        xLine.getBuffer()[pxThis->_usRXLength++]=static_cast<char>(ucOut);
+                    }
+                }
+
+                if (ucAction & eFRAME_END) {
+                    if (pxThis->_usRXTotal>pxThis->_xLineStats.usLengthMax) {
+                        pxThis->_xLineStats.usLengthMax=pxThis->_usRXTotal;
+                    }
+                    pxThis->_usRXTotal=0;
 
-                        scLast=scCurrent;
+                    if (pxThis->_usRXLength) {
+                        return lineComplete(pxThis, xLine, pxThis->_bOverflow ? eLINE_TRUNCATED : eLINE_COMPLETE);
                     }
+                    pxThis->_bOverflow=false;
+                    pxThis->_usMatchState=0;
+                    pxThis->_ulMatching=0;
+                }
+
+                return false;
+            }
 
+
+            /**
+             * Complete line being read
+             *
+             * \param pxThis Instance of CTexter (data source)
+             * \param xLine Line to store characters in
+             * \param ucFlags \ref eLINE flags of line
+             * \return Line complete state, always true
+             */
+            static bool lineComplete(cTexter<N, F> *pxThis, cTextLine<N> &xLine, const uint8_t ucFlags) {
+                xLine.setLineLength(static_cast<uint8_t>(pxThis->_usRXLength));    // install null terminator and we're done...
+
+                pxThis->_ucLineFlags=ucFlags;
+                pxThis->_usRXLength=0;
+                pxThis->_bOverflow=false;
+
+                // matching carries on over chunks of a line
+                pxThis->_ulLineMatches=pxThis->_ulMatching;
+                if (!(ucFlags & eLINE_PARTIAL)) {
+                    pxThis->_usMatchState=0;
+                    pxThis->_ulMatching=0;
+                }
+
+                return true;
+            }
+
+
+            /**
+             * Blocking read line (frame) as character string from given \ref cTexter instance.  Only delays when no characters are available
+             *
+             * \param pxThis Instance of CTexter (data source)
+             * \param xLine Line to store characters in
+             */
+            static void blockingReadLine(cTexter<N, F> *pxThis, cTextLine<N> &xLine) {
+                while(!readLine(pxThis, xLine)) {
                     pxThis->characterReadDelay();
                 }
             }
@@ -175,7 +462,7 @@ namespace nText {
              * \param pxThis Instance of CTexter (data destination)
              * \param pscData Data buffer of source characters
              */
-            static void blockingWriteLine(cTexter<N> *pxThis, const char *pscData) {
+            static void blockingWriteLine(cTexter<N, F> *pxThis, const char *pscData) {
                 char    ucLength=0,scCurrent;
 
                 while(1) {
@@ -190,6 +477,24 @@ namespace nText {
                 }
             }
 
+
+        protected:
+            char                _scChunk[CTEXTER_RX_CHUNK_MAX];     ///< Characters staged by \ref characterReadMany
+            uint8_t             _ucChunkHead;                       ///< Next staged character
+            uint8_t             _ucChunkTail;                       ///< Staged character count
+            uint16_t            _usRXLength;                        ///< Incomplete line length (characters)
+            uint16_t            _usRXTotal;                         ///< Incomplete line length including overflow (bytes)
+            eOVERFLOW           _eOverflow;                         ///< Overflow policy
+            bool                _bOverflow;                         ///< Incomplete line overflowed, rest of it dropped state
+            uint8_t             _ucLineFlags;                       ///< Last line \ref eLINE flags
+            uint8_t             _ucPendingAction;                   ///< Held over \ref eFRAME flags, \ref eOVERFLOW_PARTIAL
+            uint8_t             _ucPending;                         ///< Held over byte, \ref eOVERFLOW_PARTIAL
+            tLineStats          _xLineStats;
+            const cMatcher*     _pxMatcher;                         ///< Pattern matcher or NULL
+            uint16_t            _usMatchState;                      ///< Pattern matcher state
+            uint32_t            _ulMatching;                        ///< Patterns matched in incomplete line
+            uint32_t            _ulLineMatches;                     ///< Patterns matched in last line
+            F                   _xFramer;                           ///< Framing engine
     }; // class cTexter
 
 } // namespace nText
@@ -0,0 +1,117 @@
+#!/usr/bin/python
+# script used to generate Aho-Corasick automaton tables (PROGMEM header) for nText::cMatcher from a list of patterns
+from __future__ import print_function
+import sys
+import re
+import argparse
+
+# source: https://stackoverflow.com/questions/5574702/how-to-print-to-stderr-in-python
+def eprint(*args, **kwargs):
+    print(*args, file=sys.stderr, **kwargs)
+
+def load_file(fn,sp="\n"):
+    # load file as array of strings, split by newline
+    a = []
+    with open(fn, "r") as text_file:
+        a = text_file.read().split(sp)
+    # last line empty?
+    if len(a[-1]) == 0:
+        del a[-1]
+    return a
+
+def unescape(p):
+    # allow C style escapes in patterns, e.g. "OK\r\n"
+    return p.encode("latin-1").decode("unicode_escape").encode("latin-1")
+
+def build(patterns):
+    # trie, state 0 root.  goto as list of dict byte:state
+    goto = [{}]
+    match = [0]
+    for pid, p in enumerate(patterns):
+        s = 0
+        for b in bytearray(p):
+            if b not in goto[s]:
+                goto.append({})
+                match.append(0)
+                goto[s][b] = len(goto) - 1
+            s = goto[s][b]
+        match[s] |= 1 << pid
+
+    # failure links breadth first, match masks inherit those of failure state
+    fail = [0] * len(goto)
+    queue = list(goto[0].values())
+    while queue:
+        r = queue.pop(0)
+        for b, s in sorted(goto[r].items()):
+            queue.append(s)
+            f = fail[r]
+            while f and b not in goto[f]:
+                f = fail[f]
+            fail[s] = goto[f][b] if (b in goto[f] and goto[f][b] != s) else 0
+            match[s] |= match[fail[s]]
+    return goto, fail, match
+
+def c_array(ctype, name, values, per_line=12):
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append("    " + ", ".join(str(v) for v in values[i:i + per_line]) + ",")
+    return "static const %s %s[] PROGMEM = {\n%s\n};\n" % (ctype, name, "\n".join(lines) if lines else "    0,")
+
+def macro_name(prefix, p):
+    return (prefix + "_" + re.sub(r"[^A-Za-z0-9]", "_", p.decode("latin-1"))).upper()
+
+if __name__ == '__main__':
+    # parse shell args
+    parser = argparse.ArgumentParser(description="acgen.py generates nText::cMatcher Aho-Corasick tables as a PROGMEM header")
+    parser.add_argument("-n", "--name", dest="name", help="Table name, C identifier", action="store", required=True)
+    parser.add_argument("-o", "--output", dest="outfile", help="Output header file", action="store", required=True)
+    parser.add_argument("-f", "--file", dest="infile", help="Input file of patterns, one per line", action="store", required=False)
+    parser.add_argument("patterns", help="Patterns, C style escapes allowed", nargs="*")
+    try:
+        args = parser.parse_args()
+    except:
+        eprint("ERROR: argument parsing??")
+        exit(1)
+
+    patterns = list(args.patterns)
+    if args.infile:
+        patterns += load_file(args.infile)
+    patterns = [unescape(p) for p in patterns if len(p)]
+    if not patterns or len(patterns) > 32:
+        eprint("ERROR: 1 to 32 patterns required")
+        exit(1)
+
+    goto, fail, match = build(patterns)
+    if len(goto) > 0xFFFF:
+        eprint("ERROR: too many states")
+        exit(1)
+
+    # flatten edges, sorted per state
+    edge_first = []
+    edge_byte = []
+    edge_next = []
+    for s in range(len(goto)):
+        edge_first.append(len(edge_byte))
+        for b, n in sorted(goto[s].items()):
+            edge_byte.append(b)
+            edge_next.append(n)
+    edge_first.append(len(edge_byte))
+
+    n = args.name
+    guard = n.lower() + "_h"
+    out = []
+    out.append("/**\n * \\file\n * Pattern matcher tables for nText::cMatcher, generated by tools/acgen.py.  Do not edit\n */\n")
+    out.append("#ifndef %s\n#define %s\n" % (guard, guard))
+    for pid, p in enumerate(patterns):
+        out.append("#define %-32s (1UL<<%d)    // \"%s\"" % (macro_name(n, p), pid, p.decode("latin-1").encode("unicode_escape").decode("latin-1")))
+    out.append("")
+    out.append(c_array("uint16_t", n + "EdgeFirst", edge_first))
+    out.append(c_array("uint8_t", n + "EdgeByte", edge_byte))
+    out.append(c_array("uint16_t", n + "EdgeNext", edge_next))
+    out.append(c_array("uint16_t", n + "Fail", fail))
+    out.append(c_array("uint32_t", n + "Match", ["%dUL" % m for m in match], 6))
+    out.append("static const nText::cMatcher::tTable %sTable = { %sEdgeFirst, %sEdgeByte, %sEdgeNext, %sFail, %sMatch };\n" % (n, n, n, n, n, n))
+    out.append("#endif // %s" % guard)
+
+    with open(args.outfile, "w") as text_file:
+        text_file.write("\n".join(out) + "\n")
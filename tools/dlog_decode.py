@@ -0,0 +1,227 @@
+#!/usr/bin/python
+# script used to decode nText::cDLog deferred binary log records, format strings are found by scanning sources for DLOG(...)
+from __future__ import print_function
+import sys
+import re
+import struct
+import argparse
+
+# source: https://stackoverflow.com/questions/5574702/how-to-print-to-stderr-in-python
+def eprint(*args, **kwargs):
+    print(*args, file=sys.stderr, **kwargs)
+
+def unescape(p):
+    # C style escapes in format strings, e.g. "%d\r\n"
+    return p.encode("latin-1").decode("unicode_escape").encode("latin-1")
+
+def dlog_id(b):
+    # FNV-1a 32 bit folded to 16 bits, same as nText::dlogId
+    h = 2166136261
+    for c in bytearray(b):
+        h = ((h ^ c) * 16777619) & 0xFFFFFFFF
+    return ((h >> 16) ^ (h & 0xFFFF)) & 0xFFFF
+
+def literal(text, i):
+    # string literal starting at text[i] == '"', returns body and index after closing quote
+    j = i + 1
+    while text[j] != '"':
+        j += 2 if '\\' == text[j] else 1
+    return text[i + 1:j], j + 1
+
+def arguments(text, i):
+    # split call arguments starting after '(' at text[i], nesting and literals respected.  Returns list of argument texts
+    args = []
+    depth = 0
+    start = i
+    while i < len(text):
+        c = text[i]
+        if c in "\"'":
+            if '"' == c:
+                _, i = literal(text, i)
+            else:
+                i += 1
+                while text[i] != "'":
+                    i += 2 if '\\' == text[i] else 1
+                i += 1
+            continue
+        if c in "([{":
+            depth += 1
+        elif c in ")]}":
+            if not depth:
+                args.append(text[start:i])
+                return args
+            depth -= 1
+        elif "," == c and not depth:
+            args.append(text[start:i])
+            start = i + 1
+        i += 1
+    return None
+
+def format_string(arg):
+    # adjacent string literals concatenate, anything else is not a literal format
+    out = b""
+    i = 0
+    arg = arg.strip()
+    if not arg.startswith('"'):
+        return None
+    while i < len(arg):
+        if arg[i].isspace():
+            i += 1
+        elif '"' == arg[i]:
+            body, i = literal(arg, i)
+            out += unescape(body)
+        else:
+            return None
+    return out
+
+def strip_comments(text):
+    # drop comments, keeping literals intact
+    return re.sub(r'//[^\n]*|/\*.*?\*/|("(?:[^"\\]|\\.)*"|\'(?:[^\'\\]|\\.)*\')',
+                  lambda m: m.group(1) or " ", text, flags=re.S)
+
+def scan(files):
+    # table id:format from DLOG(x, "format", ...) in sources
+    table = {}
+    rex = re.compile(r'\bDLOG\s*\(')
+    for fn in files:
+        with open(fn, "r") as text_file:
+            text = strip_comments(text_file.read())
+        for m in rex.finditer(text):
+            args = arguments(text, m.end())
+            if not args or len(args) < 2:
+                continue
+            f = format_string(args[1])
+            if f is None:
+                continue
+            i = dlog_id(f)
+            if i in table and table[i] != f:
+                eprint("WARNING: ID 0x%04x collision '%s' '%s'" % (i, table[i], f))
+            table[i] = f
+    return table
+
+def cobs_decode(d):
+    out = bytearray()
+    i = 0
+    while i < len(d):
+        code = d[i]
+        if 0 == code or i + code > len(d):
+            return None
+        out += d[i + 1:i + code]
+        i += code
+        if code < 0xFF and i < len(d):
+            out.append(0)
+    return out
+
+def varint(d, i):
+    v = 0
+    s = 0
+    while True:
+        b = d[i]
+        i += 1
+        v |= (b & 0x7F) << s
+        s += 7
+        if not (b & 0x80):
+            return v, i
+
+# conversion: flags width precision length type
+CONV = re.compile(r"%([-+ #0]*)(\d*)(\.\d+)?(hh|h|ll|l|j|z|t|L)?([diouxXcsfFeEgGaAp%])")
+
+# argument type tags, nText::eDLOG.  Signed tags give their size (bits)
+UNSIGNED, CHAR, FLOAT, STRING = 0, 5, 6, 7
+SIGNED_BITS = {1: 8, 2: 16, 3: 32, 4: 64}
+LENGTH_BITS = {"hh": 8, "h": 16, "ll": 64}
+
+def argument(d, i, tag):
+    # value of argument by type tag, returns value and index after it
+    if UNSIGNED == tag:
+        return varint(d, i)
+    if tag in SIGNED_BITS:
+        v, i = varint(d, i)
+        return (v >> 1) ^ -(v & 1), i
+    if CHAR == tag:
+        return d[i], i + 1
+    if FLOAT == tag:
+        return struct.unpack("<f", bytes(d[i:i + 4]))[0], i + 4
+    if STRING == tag:
+        l = d[i]
+        return d[i + 1:i + 1 + l].decode("latin-1"), i + 1 + l
+    raise ValueError("tag")
+
+def decode(f, d):
+    # format record arguments, decoded by type tag then converted as the format string asks
+    f = f.decode("latin-1")
+    convs = [m for m in CONV.finditer(f) if "%" != m.group(5)]
+    i = 2 + (len(convs) + 1) // 2
+    tags = [(d[2 + n // 2] >> ((n & 1) * 4)) & 0x0F for n in range(len(convs))]
+    out = ""
+    last = 0
+    n = 0
+    for m in CONV.finditer(f):
+        out += f[last:m.start()]
+        last = m.end()
+        flags, width, prec, length, conv = m.groups()
+        spec = "%" + flags + width + (prec or "")
+        if "%" == conv:
+            out += "%"
+            continue
+        tag = tags[n]
+        n += 1
+        v, i = argument(d, i, tag)
+        if STRING == tag and "s" != conv:
+            raise ValueError("string")
+        if "s" == conv:
+            out += (spec + "s") % v
+        elif conv in "fFeEgGaA":
+            out += (spec + conv) % float(v)
+        elif "c" == conv:
+            out += (spec + "c") % chr(int(v) & 0xFF)
+        elif conv in "di":
+            out += (spec + "d") % int(v)
+        else:
+            # negatives as the target's unsigned of the argument size, or length modifier
+            v = int(v)
+            if v < 0:
+                v &= (1 << LENGTH_BITS.get(length, SIGNED_BITS.get(tag, 32))) - 1
+            out += ("0x%x" % v) if "p" == conv else (spec + conv) % v
+    return out + f[last:]
+
+if __name__ == '__main__':
+    # parse shell args
+    parser = argparse.ArgumentParser(description="dlog_decode.py decodes nText::cDLog binary log records using formats found in sources")
+    parser.add_argument("-i", "--input", dest="infile", help="Input capture file, default stdin", action="store", required=False)
+    parser.add_argument("-l", "--list", dest="list", help="List format IDs and exit", action="store_const", const=True, required=False)
+    parser.add_argument("sources", help="Source files containing DLOG(...)", nargs="+")
+    try:
+        args = parser.parse_args()
+    except:
+        eprint("ERROR: argument parsing??")
+        exit(1)
+
+    table = scan(args.sources)
+    if args.list:
+        for i, f in sorted(table.items()):
+            print("0x%04x %s" % (i, f.decode("latin-1").encode("unicode_escape").decode("latin-1")))
+        exit(0)
+
+    if args.infile:
+        with open(args.infile, "rb") as bin_file:
+            data = bytearray(bin_file.read())
+    else:
+        data = bytearray(getattr(sys.stdin, "buffer", sys.stdin).read())
+
+    # records delimited by 0x00
+    for frame in data.split(b"\x00"):
+        if not frame:
+            continue
+        d = cobs_decode(frame)
+        if d is None or len(d) < 2:
+            eprint("ERROR: bad frame %s" % frame.hex() if hasattr(frame, "hex") else "ERROR: bad frame")
+            continue
+        i = d[0] | (d[1] << 8)
+        if i not in table:
+            eprint("ERROR: unknown ID 0x%04x" % i)
+            continue
+        try:
+            sys.stdout.write(decode(table[i], d))
+        except (IndexError, struct.error, TypeError, ValueError):
+            eprint("ERROR: record 0x%04x arguments do not match format" % i)
@@ -0,0 +1,82 @@
+#!/usr/bin/python
+# script used to decode nText::cCompressLZSS compressed streams, e.g. captured UART TX
+from __future__ import print_function
+import sys
+import argparse
+
+# source: https://stackoverflow.com/questions/5574702/how-to-print-to-stderr-in-python
+def eprint(*args, **kwargs):
+    print(*args, file=sys.stderr, **kwargs)
+
+class BitReader(object):
+    # most significant bit first
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def remaining(self):
+        return len(self.data) * 8 - self.pos
+
+    def read(self, n):
+        v = 0
+        for _ in range(n):
+            v = (v << 1) | ((self.data[self.pos >> 3] >> (7 - (self.pos & 7))) & 1)
+            self.pos += 1
+        return v
+
+    def align(self):
+        self.pos = (self.pos + 7) & ~7
+
+def decode(data, w, l):
+    out = bytearray()
+    r = BitReader(data)
+    while r.remaining() >= 9:
+        if r.read(1):
+            out.append(r.read(8))
+            continue
+        if r.remaining() < w:
+            break
+        offset = r.read(w)
+        if 0 == offset:
+            # end of block
+            r.align()
+            continue
+        if r.remaining() < l:
+            break
+        length = r.read(l) + 2
+        if offset > len(out):
+            raise ValueError("offset %d beyond history %d" % (offset, len(out)))
+        for _ in range(length):
+            out.append(out[-offset])
+    return out
+
+if __name__ == '__main__':
+    # parse shell args
+    parser = argparse.ArgumentParser(description="lzss_decode.py decodes nText::cCompressLZSS streams")
+    parser.add_argument("-i", "--input", dest="infile", help="Input capture file, default stdin", action="store", required=False)
+    parser.add_argument("-o", "--output", dest="outfile", help="Output file, default stdout", action="store", required=False)
+    parser.add_argument("-w", "--window", dest="window", help="Window size bits, template W (default 8)", action="store", type=int, default=8)
+    parser.add_argument("-l", "--length", dest="length", help="Match length bits, template L (default 4)", action="store", type=int, default=4)
+    try:
+        args = parser.parse_args()
+    except:
+        eprint("ERROR: argument parsing??")
+        exit(1)
+
+    if args.infile:
+        with open(args.infile, "rb") as bin_file:
+            data = bytearray(bin_file.read())
+    else:
+        data = bytearray(getattr(sys.stdin, "buffer", sys.stdin).read())
+
+    try:
+        out = decode(data, args.window, args.length)
+    except ValueError as e:
+        eprint("ERROR: %s" % e)
+        exit(1)
+
+    if args.outfile:
+        with open(args.outfile, "wb") as bin_file:
+            bin_file.write(out)
+    else:
+        getattr(sys.stdout, "buffer", sys.stdout).write(out)